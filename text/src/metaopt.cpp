@@ -18,14 +18,18 @@
 
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <limits>
 #include <tuple>
 #include <cinttypes>
+#include <csignal>
 
 #include <boost/unordered_map.hpp>
 #include <boost/program_options.hpp>
 
 #include "Properties.h"
 #include "algorithms/FVA.h"
+#include "algorithms/FVAResultFile.h"
 #include "algorithms/BlockingSet.h"
 
 #include "model/Precision.h"
@@ -38,12 +42,24 @@
 #include "scip/constraints/SteadyStateConstraint.h"
 #include "scip/constraints/ThermoConstraintHandler.h"
 #include "scip/heur/CycleDeletionHeur.h"
+#include "scip/event/InterruptEventHandler.h"
 
 namespace metaopt {
 
     using namespace boost;
     using namespace std;
 
+    /**
+     * Cancelled on Ctrl-C, so that long runs stop cleanly (e.g. with a consistent journal).
+     */
+    static CancellationTokenPtr interruptToken(new CancellationToken());
+
+    static void onInterrupt(int) {
+        interruptToken->cancel();
+        // a second Ctrl-C terminates immediately, e.g. if the solver does not check the token
+        signal(SIGINT, SIG_DFL);
+    }
+
     int fba(const TextLoader& loader) {
         ModelPtr model = loader.getModel();
 
@@ -130,8 +146,12 @@ namespace metaopt {
         createThermoConstraint(scip);
         createCycleDeletionHeur(scip);
         //registerExitEventHandler(scip);
+        createInterruptEventHandler(scip, interruptToken);
 
         scip->solve();
+        if (interruptToken->isCancelled()) {
+            cout << "Warning: tfba interrupted, the solution may not be optimal" << endl;
+        }
 
         bool solFound = scip->isOptimal();
 
@@ -261,6 +281,35 @@ namespace metaopt {
         }
     }
 
+/**
+ * Prints the intervals computed by an anytime tfva run, one line per reaction:
+ * outer and inner bound of the minimal flux, then inner and outer bound of the maximal flux.
+ * The order of the reactions is the same as they were loaded.
+ */
+    void convert_fva_bounds(metaopt::ModelPtr &model, const metaopt::TextLoader &loader,
+                            boost::unordered_map<metaopt::ReactionPtr, FVABound> &min,
+                            boost::unordered_map<metaopt::ReactionPtr, FVABound> &max) {
+        for (int i = 0; i < model->getReactions().size(); i++) {
+            ReactionPtr rxn = loader.getReaction(i);
+            unordered_map<ReactionPtr, FVABound>::iterator iter_min = min.find(rxn);
+            unordered_map<ReactionPtr, FVABound>::iterator iter_max = max.find(rxn);
+
+            FVABound min_bound(-INFINITY, FVA_BOUNDED), max_bound(INFINITY, FVA_BOUNDED);
+            min_bound.inner = INFINITY;
+            max_bound.inner = -INFINITY;
+            if (iter_min == min.end() || iter_max == max.end()) {
+                cout << "Error: Did not run FVA for a reaction " << i << " - computation aborted?" << endl;
+            }
+            if (iter_min != min.end()) {
+                min_bound = iter_min->second;
+            }
+            if (iter_max != max.end()) {
+                max_bound = iter_max->second;
+            }
+            cout << min_bound.outer << " " << min_bound.inner << " " << max_bound.inner << " " << max_bound.outer << endl;
+        }
+    }
+
 /**
  * Octave wrapper to plain old FVA
 
@@ -302,30 +351,102 @@ public:
 };*/
 
 /**
- * Octave wrapper to thermodynamically constrained FVA
+ * Runs plain FVA (without thermodynamic constraints) with settings->threads threads and prints the results (see FVA.h)
  */
-    int tfva(const TextLoader& loader, int nargout, double timeout) {
+    int fva(const TextLoader& loader, FVASettingsPtr settings) {
         ModelPtr model = loader.getModel();
 
-        // FVA settings
-        FVASettingsPtr settings(new FVASettings());
+        unordered_map<metaopt::ReactionPtr, double> min, max;
+        try {
+            metaopt::fva(model, settings, min, max);
+        } catch (std::exception &ex) {
+            std::cout << diagnostic_information(ex) << std::endl;
+            return 19;
+        }
+        convert_fva_result(model, loader, min, max);
+        return 0;
+    }
+
+/**
+ * Octave wrapper to thermodynamically constrained FVA
+ */
+    int tfva(const TextLoader& loader, int nargout, FVASettingsPtr settings,
+             unsigned int shard = 0, unsigned int num_shards = 0, const string& output = string()) {
+        ModelPtr model = loader.getModel();
 
         settings->reactions = model->getReactions();
-        if (timeout > 0) {
-            settings->timeout = timeout;
+        if (num_shards > 0) {
+            // every num_shards-th reaction in the order of the input, so that all processes agree on the shards
+            settings->reactions.clear();
+            for (unsigned int i = shard; i < model->getReactions().size(); i += num_shards) {
+                settings->reactions.insert(loader.getReaction(i));
+            }
+            cout << "Computing shard " << shard << " of " << num_shards << " with " << settings->reactions.size() << " reactions" << endl;
+        }
+
+        if (settings->anytime) {
+            // anytime mode never aborts by timeout, but reports intervals for unfinished bounds
+            unordered_map<metaopt::ReactionPtr, FVABound> min, max;
+            try {
+                metaopt::tfva(model, settings, min, max);
+            } catch (std::exception &ex) {
+                std::cout << diagnostic_information(ex) << std::endl;
+                return 19;
+            }
+            convert_fva_bounds(model, loader, min, max);
+            return 0;
         }
 
         unordered_map<metaopt::ReactionPtr, double> min, max;
 
+        int result = 0;
         try {
             metaopt::tfva(model, settings, min, max);
+        } catch (TimeoutError &ex) {
+            cout << "Warning: tfva aborted by timeout, the results are incomplete" << endl;
+            result = 19;
+        } catch (CancelledError &ex) {
+            cout << "Warning: tfva interrupted, the results are incomplete" << endl;
+            result = 19;
         } catch (std::exception &ex) {
             std::cout << diagnostic_information(ex) << std::endl;
-            return 19;
+            result = 19;
+        }
+        if (result != 0 && !settings->journal.empty()) {
+            cout << "Computed bounds are stored in " << settings->journal << ", use --resume to continue" << endl;
+        }
+
+        if (num_shards > 0) {
+            // only complete shards are written, so that merge never sees partial results
+            if (result == 0) {
+                FVAResultFile::write(output, model, describeResultSettings(model, settings), shard, num_shards, min, max);
+                cout << "Wrote shard " << shard << " of " << num_shards << " to " << output << endl;
+            } else {
+                cout << "Shard is incomplete, did not write " << output << endl;
+            }
+            return result;
         }
 
+        // also print partial results, missing bounds are reported by convert_fva_result
         convert_fva_result(model, loader, min, max);
 
+        return result;
+    }
+
+/**
+ * Merges the result files of a sharded tfva run (see --shard) and prints the results
+ */
+    int merge(const TextLoader& loader, FVASettingsPtr settings, const vector<string>& files) {
+        ModelPtr model = loader.getModel();
+
+        unordered_map<metaopt::ReactionPtr, double> min, max;
+        try {
+            FVAResultFile::merge(model, describeResultSettings(model, settings), files, min, max);
+        } catch (std::exception &ex) {
+            std::cout << diagnostic_information(ex) << std::endl;
+            return 18;
+        }
+        convert_fva_result(model, loader, min, max);
         return 0;
     }
 
@@ -394,7 +515,7 @@ public:
         cout << "tfva: for tfva (with thermodynamic constraints). This ignores any specified objective function."
              << endl;
         cout
-                << "      If you want to run fva only on the optimal flux space, you have to make a separate call to tfba and constrain the flux space accordingly."
+                << "      To run tfva only on the optimal flux space, use --optimality-fraction. The tfba optimum is then computed as part of the run."
                 << endl;
         cout << "  Input Parameters:" << endl;
         cout << "   - a metabolic network model. See below for a precise specification." << endl;
@@ -407,6 +528,13 @@ public:
         cout << "     The first column gives the minimal flux for each reaction." << endl;
         cout << "     The second column gives maximal flux for each reaction." << endl;
         cout << endl;
+        cout << "merge: combines the result files of a tfva run that was split with --shard i/n into the normal output."
+             << endl;
+        cout << "       The result files are given with --merge and must have been computed on the same model with the same tolerances."
+             << endl;
+        cout << "       Options that influence the results (e.g. --optimality-fraction) must be given to merge as well."
+             << endl;
+        cout << endl;
         cout << "help: Prints this message." << endl << endl;
         cout << "Specification of metabolic network model:" << endl;
         cout << "  The metabolic network model is struct which is basically a COBRA model with additional fields:"
@@ -449,7 +577,26 @@ int main(int argc, const char *argv[]) {
                 ("reactions,r", opt::value<string>()->required(), "Reactions file")
                 ("metabolites,m", opt::value<string>()->required(), "Metabolites file")
                 ("solver,s", opt::value<string>()->required(), "Solver type")
-                ("output,o", opt::value<string>()->required()->default_value("output.txt"), "Output file");
+                ("output,o", opt::value<string>()->required()->default_value("output.txt"), "Output file")
+                ("threads,t", opt::value<int>()->default_value(1), "Number of threads (fva, tfva)")
+                ("timeout", opt::value<double>()->default_value(-1), "Timeout in seconds (tfva)")
+                ("pipeline", "Screen all reactions by LP before solving CIPs (tfva)")
+                ("journal,j", opt::value<string>(), "Record computed bounds in this journal file (tfva)")
+                ("resume", "Continue the run recorded in the journal (tfva)")
+                ("anytime", "Report intervals for bounds that are not finished within the timeout (tfva)")
+                ("cip-timeout", opt::value<double>()->default_value(-1), "Time limit for a single CIP in anytime mode (tfva)")
+                ("persistent", "Reuse one CIP per thread for all reactions (tfva)")
+                ("witnesses", opt::value<int>()->default_value(0), "Number of feasible fluxes kept as start solutions (e.g. 32), 0 disables (tfva)")
+                ("feasibility-cache", opt::value<int>()->default_value(0), "Number of reaction sign patterns whose thermodynamic feasibility is shared by all threads (e.g. 100000), 0 disables (tfva)")
+                ("infeasible-sets", opt::value<int>()->default_value(0), "Number of infeasible sets shared by all CIPs (e.g. 256), 0 disables (tfva)")
+                ("share-coupling", "Share the couplings learned in presolving among all CIPs, disables dual reductions (tfva)")
+                ("race-after", opt::value<double>()->default_value(-1), "Seconds after which a second formulation is raced against a CIP on another core, -1 disables (tfva)")
+                ("optimality-fraction", opt::value<double>()->default_value(-1), "Analyze only fluxes attaining this fraction (0 to 1) of the tfba optimum, -1 analyzes all fluxes (tfva)")
+                ("deterministic", "Schedule independent of thread timing: fixed schedule, cold LP starts and no sharing between threads, slower (tfva)")
+                ("reduce-domain", "Tighten flux bounds with every computed bound (tfva)")
+                ("cache", opt::value<string>(), "Directory for cached results (fva, tfva)")
+                ("shard", opt::value<string>(), "Compute only shard i/n (0 <= i < n) of the reactions and write it to the output file (tfva)")
+                ("merge", opt::value<vector<string> >()->multitoken(), "Result files of all shards to merge (solver merge)");
 
         opt::parsed_options parsed_options = parser.options(options).run();
         opt::store(parsed_options, args);
@@ -471,6 +618,58 @@ int main(int argc, const char *argv[]) {
         cout << "Using solver type: " << args["solver"].as<string>() << endl;
         cout << "Using output file: " << args["output"].as<string>() << endl;
 
+        // FVA settings
+        metaopt::FVASettingsPtr settings(new metaopt::FVASettings());
+        settings->threads = args["threads"].as<int>();
+        settings->timeout = args["timeout"].as<double>();
+        settings->pipeline = args.count("pipeline") > 0;
+        if (args.count("journal")) {
+            settings->journal = args["journal"].as<string>();
+        }
+        settings->resume = args.count("resume") > 0;
+        settings->anytime = args.count("anytime") > 0;
+        settings->cip_timeout = args["cip-timeout"].as<double>();
+        settings->persistent = args.count("persistent") > 0;
+        settings->witnesses = args["witnesses"].as<int>();
+        settings->feasibility_cache = args["feasibility-cache"].as<int>();
+        settings->infeasible_sets = args["infeasible-sets"].as<int>();
+        settings->share_coupling = args.count("share-coupling") > 0;
+        settings->race_after = args["race-after"].as<double>();
+        settings->optimality_fraction = args["optimality-fraction"].as<double>();
+        settings->deterministic = args.count("deterministic") > 0;
+        settings->cancellation = metaopt::interruptToken;
+        if (settings->deterministic) {
+            // print results with all significant digits, so that runs can be compared closely
+            cout.precision(numeric_limits<double>::max_digits10);
+        }
+        settings->reduce_domain = args.count("reduce-domain") > 0;
+        if (args.count("cache")) {
+            settings->cache = args["cache"].as<string>();
+        }
+        if (settings->resume && settings->journal.empty()) {
+            throw std::runtime_error("--resume requires --journal");
+        }
+        if (settings->optimality_fraction > 1) {
+            throw std::runtime_error("--optimality-fraction must not exceed 1");
+        }
+
+        // sharding
+        unsigned int shard = 0, num_shards = 0;
+        if (args.count("shard")) {
+            istringstream spec(args["shard"].as<string>());
+            char slash = 0;
+            if (!(spec >> shard >> slash >> num_shards) || slash != '/' || shard >= num_shards) {
+                throw std::runtime_error("--shard expects i/n with 0 <= i < n");
+            }
+            if (settings->anytime) {
+                throw std::runtime_error("--shard cannot be combined with --anytime");
+            }
+        }
+        vector<string> merge_files;
+        if (args.count("merge")) {
+            merge_files = args["merge"].as<vector<string> >();
+        }
+
         std::string line;
         std::vector<std::tuple<int, int, double>> stoichiometry;
         std::vector<std::tuple<double, double, double>> limits;
@@ -504,14 +703,21 @@ int main(int argc, const char *argv[]) {
         metaopt::TextLoader loader;
         loader.load(stoichiometry, limits, species);
 
+        // only these solvers check the token, the others keep the default behavior of Ctrl-C
+        if (solver == "tfba" || solver == "fva" || solver == "tfva") {
+            signal(SIGINT, metaopt::onInterrupt);
+        }
+
         if (solver == "fba") {
             metaopt::fba(loader);
         } else if (solver == "tfba") {
             metaopt::tfba(loader, 2);
         } else if (solver == "fva") {
-            cout << "Not implemented" << endl; // TODO
+            return metaopt::fva(loader, settings);
         } else if (solver == "tfva") {
-            metaopt::tfva(loader, 2, -1.0);
+            return metaopt::tfva(loader, 2, settings, shard, num_shards, output);
+        } else if (solver == "merge") {
+            return metaopt::merge(loader, settings, merge_files);
         }
 
     } catch (const std::exception &ex) {
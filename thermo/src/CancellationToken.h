@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * CancellationToken.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef CANCELLATIONTOKEN_H_
+#define CANCELLATIONTOKEN_H_
+
+#include <atomic>
+#include <exception>
+#include <boost/shared_ptr.hpp>
+#include <boost/exception/all.hpp>
+#include <boost/throw_exception.hpp>
+
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/** Thrown if a computation notices that its CancellationToken was cancelled */
+struct CancelledError : virtual boost::exception, virtual std::exception {};
+
+/**
+ * Cooperative cancellation of long running computations.
+ *
+ * The owner of a computation may cancel the token at any time from any thread (even from a signal handler).
+ * The computation checks the token regularly: loops over reactions or LPs call checkCancelled, which throws a CancelledError,
+ * and SCIP solves are interrupted by an InterruptEventHandler polling the token.
+ */
+class CancellationToken : Uncopyable {
+public:
+	CancellationToken() : _cancelled(false) {};
+
+	/**
+	 * Requests the cancellation of all computations that use this token.
+	 */
+	inline void cancel();
+
+	/**
+	 * Checks if cancel was called.
+	 */
+	inline bool isCancelled() const;
+
+private:
+	std::atomic<bool> _cancelled;
+};
+
+void CancellationToken::cancel() {
+	_cancelled.store(true);
+}
+
+bool CancellationToken::isCancelled() const {
+	return _cancelled.load();
+}
+
+typedef boost::shared_ptr<CancellationToken> CancellationTokenPtr;
+
+/**
+ * Throws a CancelledError, if token is set and was cancelled.
+ */
+inline void checkCancelled(const CancellationTokenPtr& token) {
+	if(token && token->isCancelled()) {
+		BOOST_THROW_EXCEPTION( CancelledError() );
+	}
+}
+
+} /* namespace metaopt */
+#endif /* CANCELLATIONTOKEN_H_ */
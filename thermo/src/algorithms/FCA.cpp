@@ -37,7 +37,7 @@ using namespace std;
 
 namespace metaopt {
 
-void fca(ModelPtr model, CouplingPtr coupling) {
+void fca(ModelPtr model, CouplingPtr coupling, CancellationTokenPtr token) {
 	/**
 	 * this is the naive, stupid implementation.
 	 * TODO: a smart implementation (e.g. like in F2C2 by Larhlimi et al. 2012)
@@ -55,13 +55,14 @@ void fca(ModelPtr model, CouplingPtr coupling) {
 
 	}
 	// compute blocked fluxes to save computation time
-	fva(test, min, max);
+	fva(test, min, max, 1, token);
 
 	const PrecisionPtr& testPrec = test->getPrecision();
 
 	int count = 0;
 	unordered_set<ReactionPtr> notCheck;
 	foreach(ReactionPtr a, model->getReactions()) {
+		checkCancelled(token);
 		if(min[a] < -testPrec->getCheckTol()) {
 			test->setLb(a,0);
 			notCheck.clear();
@@ -29,6 +29,7 @@
 #include "model/Model.h"
 #include "model/Coupling.h"
 #include "Properties.h"
+#include "CancellationToken.h"
 
 namespace metaopt {
 
@@ -36,8 +37,10 @@ namespace metaopt {
  * Runs flux coupling analysis and inserts the computed couplings into coupling.
  * This only adds coupled reaction pairs.
  * If you want to use the data, you must first call coupling->computeClosure();
+ * If token is given and cancelled, the analysis stops before the next reaction and throws a CancelledError.
+ * The couplings found so far remain in coupling.
  */
-void fca(ModelPtr model, CouplingPtr coupling);
+void fca(ModelPtr model, CouplingPtr coupling, CancellationTokenPtr token = CancellationTokenPtr());
 
 
 } /* namespace metaopt */
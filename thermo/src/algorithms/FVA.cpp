@@ -25,44 +25,259 @@
 
 #include <iostream>
 #include <fstream>
-#include <time.h>
 #include <math.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <algorithm>
+#include <functional>
+#include <deque>
+#include <sstream>
+#include <iomanip>
 #include "scip/scip.h"
 
 #include "FVA.h"
+#include "TFVAWorker.h"
+#include "WorkStealingScheduler.h"
+#include "FVAJournal.h"
+#include "FVAModelDiff.h"
+#include "FVACache.h"
+#include "model/ModelHash.h"
+#include "model/DirectedReaction.h"
+#include "scip/event/InterruptEventHandler.h"
+#include "Uncopyable.h"
 #include "Properties.h"
-#include "model/scip/LPPotentials.h"
-#include "scip/constraints/SteadyStateConstraint.h"
-#include "scip/constraints/ThermoConstraintHandler.h"
-#include "scip/heur/CycleDeletionHeur.h"
 
 using namespace boost;
 
 namespace metaopt {
 
-void fva(ModelPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max ) {
+// metabolites involved in more reactions (like ATP or water) do not indicate locality
+#define LOCALITY_MAX_DEGREE 20
+
+/**
+ * Sorts the reactions such that consecutive reactions are close in the network,
+ * so that consecutive LPs have similar optimal bases and warm starts pay off.
+ *
+ * The reactions are traversed breadth first, where two reactions are adjacent if they share a metabolite
+ * that is involved in at most LOCALITY_MAX_DEGREE reactions.
+ * Ties are broken by name, so the order does not depend on pointer hashes and run times are reproducible
+ * (as long as reaction names are unique).
+ */
+static void orderByLocality(ModelPtr model, vector<ReactionPtr>& reactions) {
+	unsigned int n = reactions.size();
+
+	vector<pair<string, ReactionPtr> > named;
+	foreach(ReactionPtr r, reactions) {
+		named.push_back(make_pair(r->getName(), r));
+	}
+	std::stable_sort(named.begin(), named.end(), [](const pair<string, ReactionPtr>& a, const pair<string, ReactionPtr>& b) {
+		return a.first < b.first;
+	});
+
+	unordered_map<ReactionPtr, unsigned int> index; // position in name order
+	for(unsigned int i = 0; i < n; i++) {
+		index[named[i].second] = i;
+	}
+
+	// count the reactions of each metabolite in the whole model, and collect the reactions of our list
+	unordered_map<MetabolitePtr, unsigned int> degree;
+	foreach(ReactionPtr r, model->getReactions()) {
+		foreach(const Stoichiometry& s, r->getStoichiometries()) {
+			degree[s.first]++;
+		}
+	}
+	unordered_map<MetabolitePtr, vector<unsigned int> > members;
+	for(unsigned int i = 0; i < n; i++) {
+		foreach(const Stoichiometry& s, named[i].second->getStoichiometries()) {
+			if(degree[s.first] <= LOCALITY_MAX_DEGREE) {
+				members[s.first].push_back(i); // sorted by name, since i is increasing
+			}
+		}
+	}
+
+	vector<char> visited(n, false);
+	vector<ReactionPtr> ordered;
+	std::deque<unsigned int> queue;
+	for(unsigned int first = 0; first < n; first++) {
+		if(visited[first]) continue;
+		visited[first] = true;
+		queue.push_back(first);
+		while(!queue.empty()) {
+			unsigned int i = queue.front();
+			queue.pop_front();
+			ReactionPtr r = named[i].second;
+			ordered.push_back(r);
+
+			// visit metabolites in order of their names
+			vector<pair<string, MetabolitePtr> > mets;
+			foreach(const Stoichiometry& s, r->getStoichiometries()) {
+				if(members.find(s.first) != members.end()) {
+					mets.push_back(make_pair(s.first->getName(), s.first));
+				}
+			}
+			std::stable_sort(mets.begin(), mets.end(), [](const pair<string, MetabolitePtr>& a, const pair<string, MetabolitePtr>& b) {
+				return a.first < b.first;
+			});
+			for(unsigned int k = 0; k < mets.size(); k++) {
+				foreach(unsigned int j, members[mets[k].second]) {
+					if(!visited[j]) {
+						visited[j] = true;
+						queue.push_back(j);
+					}
+				}
+			}
+		}
+	}
+	assert(ordered.size() == n);
+	reactions.swap(ordered);
+}
+
+void fva(ModelPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max, unsigned int threads, CancellationTokenPtr token) {
 	LPFluxPtr flux(new LPFlux(model, true));
 	foreach (ReactionPtr r, model->getReactions()) {
 		flux->setObj(r, 0);
 	}
-	fva(flux, min, max);
+	fva(flux, min, max, threads, token);
 }
 
-void fva(LPFluxPtr flux, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max ) {
-	ModelPtr model = flux->getModel();
+void fva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max ) {
+	FVACachePtr cache;
+	if(!settings->cache.empty()) {
+		cache.reset(new FVACache(settings->cache));
+		if(cache->load(model, "fva", model->getReactions(), min, max)) {
+			return;
+		}
+	}
+
+	fva(model, min, max, settings->threads > 1 ? settings->threads : 1, settings->cancellation);
+
+	if(cache) {
+		cache->store(model, "fva", model->getReactions(), min, max);
+	}
+}
+
+/**
+ * Open reactions of fvaRange: the list is used to iterate them, the flags to look them up.
+ * Reactions are closed by clearing their flag; the list is compacted on the next scan (see settleAtBounds).
+ */
+struct OpenReactions {
+	vector<unsigned int> list;
+	vector<char> flag;
+};
+
+/**
+ * Uses the current solution of flux as witness:
+ * If an open reaction carries flux at its upper (lower) bound, the bound is its maximal (minimal) flux.
+ * Those reactions are closed in openMax (openMin) and their result is stored in max (min).
+ * The open reactions are indices into reactions, min and max are indexed in the same way.
+ * Both lists are compacted on the way.
+ *
+ * @return number of settled reactions
+ */
+static int settleAtBounds(LPFluxPtr flux, const vector<ReactionPtr>& reactions, OpenReactions& openMax, OpenReactions& openMin,
+		vector<double>& min, vector<double>& max) {
+	double tol = flux->getPrecision()->getCheckTol();
+	int settled = 0;
+	for(unsigned int k = 0; k < openMax.list.size();) {
+		unsigned int i = openMax.list[k];
+		double ub = flux->getUb(reactions[i]);
+		bool settle = openMax.flag[i] && isinf(ub) == 0 && flux->getFlux(reactions[i]) > ub - tol;
+		if(settle) {
+			max[i] = ub;
+			openMax.flag[i] = false;
+			settled++;
+		}
+		if(!openMax.flag[i]) {
+			openMax.list[k] = openMax.list.back();
+			openMax.list.pop_back();
+		}
+		else k++;
+	}
+	for(unsigned int k = 0; k < openMin.list.size();) {
+		unsigned int i = openMin.list[k];
+		double lb = flux->getLb(reactions[i]);
+		bool settle = openMin.flag[i] && isinf(lb) == 0 && flux->getFlux(reactions[i]) < lb + tol;
+		if(settle) {
+			min[i] = lb;
+			openMin.flag[i] = false;
+			settled++;
+		}
+		if(!openMin.flag[i]) {
+			openMin.list[k] = openMin.list.back();
+			openMin.list.pop_back();
+		}
+		else k++;
+	}
+	return settled;
+}
+
+/**
+ * Runs FVA for the reactions with index in [begin, end) and stores the results in min and max at the same indices.
+ * Objective coefficients of flux must be zero initially and will be zero afterwards.
+ * Before every LP, token is checked (see checkCancelled).
+ */
+static void fvaRange(LPFluxPtr flux, const vector<ReactionPtr>& reactions, unsigned int begin, unsigned int end, vector<double>& min, vector<double>& max, CancellationTokenPtr token) {
+	// reactions whose maximal (minimal) flux is not known yet
+	OpenReactions openMax, openMin;
+	openMax.flag.resize(end, false);
+	openMin.flag.resize(end, false);
+	for(unsigned int i = begin; i < end; i++) {
+		openMax.list.push_back(i);
+		openMin.list.push_back(i);
+		openMax.flag[i] = true;
+		openMin.flag[i] = true;
+	}
 
 	flux->setObjSense(true);
-	foreach(ReactionPtr a, model->getReactions()) {
+
+	/*
+	 * Every LP solution is a witness that settles all reactions at their bounds (see settleAtBounds).
+	 * To settle many reactions at once, we first maximize (minimize) the sum of all open reactions,
+	 * which pushes them towards their bounds, until this does not settle any new reactions.
+	 */
+	for(int dir = 1; dir >= -1; dir -= 2) {
+		OpenReactions& open = dir > 0 ? openMax : openMin;
+		int settled = 1;
+		while(settled > 0 && !open.list.empty()) {
+			checkCancelled(token);
+			flux->setZeroObj();
+			foreach(unsigned int i, open.list) {
+				flux->setObj(reactions[i], dir);
+			}
+			flux->solvePrimal();
+			if(!flux->isOptimal()) {
+				break; // the sum may be unbounded, so leave the rest to the single LPs
+			}
+			settled = settleAtBounds(flux, reactions, openMax, openMin, min, max);
+		}
+	}
+	flux->setZeroObj();
+
+	// solve the remaining reactions one by one (in order of the reactions), their solutions are witnesses as well
+	for(unsigned int i = begin; i < end; i++) {
+		if(!openMax.flag[i]) continue;
+		checkCancelled(token);
+		openMax.flag[i] = false;
+		ReactionPtr a = reactions[i];
 		flux->setObj(a,1);
 		flux->solvePrimal();
 		if(!flux->isOptimal()) {
 			flux->solvePrimal();
 		}
 		assert(flux->isOptimal());
-		max[a] = flux->getObjVal();
+		max[i] = flux->getObjVal();
 		flux->setObj(a,0);
+		settleAtBounds(flux, reactions, openMax, openMin, min, max);
 	}
-	foreach(ReactionPtr a, model->getReactions()) {
+	for(unsigned int i = begin; i < end; i++) {
+		if(!openMin.flag[i]) continue;
+		checkCancelled(token);
+		openMin.flag[i] = false;
+		ReactionPtr a = reactions[i];
 		flux->setObj(a,-1);
 		flux->solvePrimal();
 		if(!flux->isOptimal()) {
@@ -70,8 +285,67 @@ void fva(LPFluxPtr flux, boost::unordered_map<ReactionPtr,double >& min , boost:
 		}
 		assert(flux->isOptimal());
 
-		min[a] = -flux->getObjVal();
+		min[i] = -flux->getObjVal();
 		flux->setObj(a,0);
+		settleAtBounds(flux, reactions, openMax, openMin, min, max);
+	}
+}
+
+void fva(LPFluxPtr flux, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max ) {
+	fva(flux, min, max, 1);
+}
+
+void fva(LPFluxPtr flux, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max, unsigned int threads, CancellationTokenPtr token) {
+	ModelPtr model = flux->getModel();
+	vector<ReactionPtr> reactions(model->getReactions().begin(), model->getReactions().end());
+	orderByLocality(model, reactions);
+	unsigned int n = reactions.size();
+
+	if(threads < 1) threads = 1;
+	if(threads > n) threads = n > 0 ? n : 1;
+
+	/*
+	 * Every thread gets a contiguous block of the locality order and its own copy of the LP.
+	 * The results are written into dense arrays, where every entry is written by exactly one thread.
+	 */
+	vector<double> minv(n), maxv(n);
+	if(threads == 1) {
+		fvaRange(flux, reactions, 0, n, minv, maxv, token);
+	}
+	else {
+		// copying LPs is not thread safe, so create the copies before starting the threads
+		vector<LPFluxPtr> fluxes;
+		fluxes.push_back(flux);
+		for(unsigned int t = 1; t < threads; t++) {
+			fluxes.push_back(flux->copy());
+		}
+
+		std::exception_ptr error;
+		std::mutex lock; // protects error
+		vector<std::thread> workers;
+		for(unsigned int t = 0; t < threads; t++) {
+			workers.push_back(std::thread([&, t]() {
+				try {
+					fvaRange(fluxes[t], reactions, (t * n) / threads, ((t + 1) * n) / threads, minv, maxv, token);
+				}
+				catch(...) {
+					std::lock_guard<std::mutex> guard(lock);
+					if(!error) error = std::current_exception();
+				}
+			}));
+		}
+		foreach(std::thread& w, workers) {
+			w.join();
+		}
+		if(error) {
+			std::rethrow_exception(error);
+		}
+		flux->setObjSense(true);
+	}
+
+	for(unsigned int i = 0; i < n; i++) {
+		min[reactions[i]] = minv[i];
+		max[reactions[i]] = maxv[i];
 	}
 }
 
@@ -102,145 +376,402 @@ void fva(ModelPtr model, ModelFactory& factory, boost::unordered_map<ReactionPtr
 	}
 }
 
-class FVAThermoModelFactory : public ModelFactory {
-public:
-	CouplingPtr coupling;
+int foo = 0;
+
+/**
+ * Finds the reaction directions that are contained in internal cycles.
+ *
+ * For those directions the LP optimum will often contain a loop and the LP shortcut fails, so they are likely to require solving a CIP.
+ * We maximize the flux through all directions that are not yet known to be contained in a cycle in a network without exchange reactions.
+ * Every solution with positive objective value contains at least one new direction, so this needs only few LPs.
+ */
+static void findCycleDirections(ModelPtr model, unordered_set<DirectedReaction>& cycles) {
+	LPFluxPtr flux(new LPFlux(model, false));
+	flux->setObjSense(true);
+	double tol = flux->getPrecision()->getCheckTol();
 
-	ScipModelPtr build(ModelPtr m) {
-		ScipModelPtr scip(new ScipModel(m));
-		createSteadyStateConstraint(scip);
-		if(coupling.use_count() >= 1) {
-			createThermoConstraint(scip, coupling);
+	foreach(ReactionPtr r, model->getInternalReactions()) {
+		flux->setLb(r, r->canBwd() ? -1 : 0);
+		flux->setUb(r, r->canFwd() ? 1 : 0);
+	}
+
+	for(int fwd = 1; fwd >= 0; fwd--) {
+		flux->setZeroObj();
+		foreach(ReactionPtr r, model->getInternalReactions()) {
+			if(fwd ? r->canFwd() : r->canBwd()) {
+				flux->setObj(r, fwd ? 1 : -1);
+			}
 		}
-		else {
-			createThermoConstraint(scip);
+		bool progress = true;
+		flux->solve();
+		while(progress && flux->isOptimal() && flux->getObjVal() > tol) {
+			progress = false;
+			foreach(ReactionPtr r, model->getInternalReactions()) {
+				double val = flux->getFlux(r);
+				if(val > tol || val < -tol) {
+					cycles.insert(DirectedReaction(r, val > 0));
+					if((val > 0) == (fwd == 1) && flux->getObj(r) != 0) {
+						flux->setObj(r, 0);
+						progress = true;
+					}
+				}
+			}
+			flux->solve();
 		}
-		createCycleDeletionHeur(scip);
-		//registerExitEventHandler(scip);
+	}
+}
 
-		return scip;
+/**
+ * Finds the root of r in the ratio forest and returns the factor f with v_r = f * v_root.
+ */
+static ReactionPtr findRatioRoot(unordered_map<ReactionPtr, pair<ReactionPtr, double> >& parent, ReactionPtr r, double& factor) {
+	factor = 1;
+	pair<ReactionPtr, double>& p = parent[r];
+	if(p.first.use_count() == 0) {
+		return r;
 	}
-};
+	double f;
+	ReactionPtr root = findRatioRoot(parent, p.first, f);
+	// path compression
+	p.first = root;
+	p.second *= f;
+	factor = p.second;
+	return root;
+}
 
 /**
- * checks if a loopless free flux with the same objective value can be attained
+ * Groups the reactions into classes whose fluxes are tied by fixed ratios.
+ *
+ * If a balanced metabolite is only involved in two reactions a and b, steady state implies s_a*v_a + s_b*v_b = 0,
+ * so v_b = -s_a/s_b * v_a for every flux (in particular for every thermodynamically feasible flux).
+ * Chains of such metabolites yield classes of reactions with fixed ratios.
+ *
+ * For each i, rep[i] is the index of the representative of the class of reactions[i] and v_i = ratio[i] * v_rep[i].
+ * Representatives have rep[i] == i.
  */
-bool isLooplessFluxAttainable(LPFluxPtr sol, LPFluxPtr helper) {
-	ModelPtr model = sol->getModel();
-	const PrecisionPtr& solPrec = sol->getPrecision();
-	helper->setDirectionBounds(sol);
-	helper->setZeroObj();
-	foreach(ReactionPtr r, model->getObjectiveReactions()) {
-		if(!r->isExchange()) {
-			double val = sol->getFlux(r);
-			if(val > solPrec->getCheckTol()) {
-				helper->setObj(r, 1);
-			}
-			else if(val < -solPrec->getCheckTol()) {
-				helper->setObj(r, -1);
+static void findRatioClasses(ModelPtr model, const vector<ReactionPtr>& reactions, vector<unsigned int>& rep, vector<double>& ratio) {
+	unordered_map<MetabolitePtr, vector<pair<ReactionPtr, double> > > involved;
+	foreach(ReactionPtr r, model->getReactions()) {
+		foreach(const Stoichiometry& s, r->getStoichiometries()) {
+			if(!s.first->hasBoundaryCondition() && s.second != 0) {
+				involved[s.first].push_back(make_pair(r, s.second));
 			}
 		}
 	}
-	foreach(ReactionPtr r, model->getFluxForcingReactions()) {
-		if(!r->isExchange()) {
-			double val = sol->getFlux(r);
-			if(val > solPrec->getCheckTol()) {
-				helper->setObj(r, 1);
-			}
-			else if(val < -solPrec->getCheckTol()) {
-				helper->setObj(r, -1);
-			}
+
+	unordered_map<ReactionPtr, pair<ReactionPtr, double> > parent; // v_r = parent[r].second * v_parent[r].first
+	typedef pair<const MetabolitePtr, vector<pair<ReactionPtr, double> > > Involved;
+	foreach(const Involved& m, involved) {
+		if(m.second.size() != 2) continue;
+		double c = -m.second[0].second / m.second[1].second; // v_1 = c * v_0
+		double f0, f1;
+		ReactionPtr r0 = findRatioRoot(parent, m.second[0].first, f0);
+		ReactionPtr r1 = findRatioRoot(parent, m.second[1].first, f1);
+		// if both are already in the same class, the ratios are either consistent or the reactions are blocked; in both cases we learn nothing
+		if(r0 != r1) {
+			// f1 * v_r1 = c * f0 * v_r0
+			parent[r1] = make_pair(r0, c * f0 / f1);
 		}
 	}
-	foreach(ReactionPtr r, model->getProblematicReactions()) {
-		if(!r->isExchange()) {
-			double val = sol->getFlux(r);
-			if(val > solPrec->getCheckTol()) {
-				helper->setObj(r, 1);
-			}
-			else if(val < -solPrec->getCheckTol()) {
-				helper->setObj(r, -1);
-			}
+
+	rep.resize(reactions.size());
+	ratio.resize(reactions.size());
+	unordered_map<ReactionPtr, pair<unsigned int, double> > classes; // root -> (representative, v_rep = factor * v_root)
+	for(unsigned int i = 0; i < reactions.size(); i++) {
+		double f;
+		ReactionPtr root = findRatioRoot(parent, reactions[i], f);
+		unordered_map<ReactionPtr, pair<unsigned int, double> >::iterator iter = classes.find(root);
+		if(iter == classes.end()) {
+			classes[root] = make_pair(i, f);
+			rep[i] = i;
+			ratio[i] = 1;
+		}
+		else {
+			rep[i] = iter->second.first;
+			ratio[i] = f / iter->second.second;
 		}
 	}
-	helper->solve();
-	if(!helper->isOptimal()) { // if we weren't able to compute the optimum, we better be pessimistic
-		return false;
-	}
-#ifndef SILENT
-	std::cout << "test: " << helper->getObjVal() << std::endl;
-#endif
-	return helper->getObjVal() < helper->getPrecision()->getCheckTol();
 }
 
 /**
- * checks if a thermodynamically feasible flux with the same objective value can be attained
+ * Returns the bound on c * v for the bound b on v.
+ * For negative c, the returned bound belongs to the opposite optimization direction.
  */
-bool isThermoFluxAttainable(LPFluxPtr sol, LPFluxPtr helper, LPPotentialsPtr potTest) {
-	// make sure that subtracting cycles does not violate flux bounds or objective value
-	assert(isLooplessFluxAttainable(sol, helper));
-	ModelPtr model = sol->getModel();
-	const PrecisionPtr& solPrec = sol->getPrecision();
-	const PrecisionPtr& helperPrec = helper->getPrecision();
-#ifndef NDEBUG
-	int debugi = 0;
-#endif
-	do {
-		helper->setDirectionBounds(sol);
-		helper->setZeroObj();
-		foreach(ReactionPtr r, model->getInternalReactions()) {
-			double val = sol->getFlux(r);
-			if(val > solPrec->getCheckTol()) {
-				helper->setObj(r, 1);
+static FVABound scaleBound(const FVABound& b, double c) {
+	FVABound res = b;
+	res.outer = c * b.outer;
+	res.inner = c * b.inner;
+	return res;
+}
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * Returns the number of seconds passed since start.
+ */
+static double elapsed(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+/**
+ * Processes the tasks of the scheduler with one thread per worker.
+ * process(t, task) is called in thread t.
+ * If a task throws an exception, the remaining tasks are dropped and the exception is rethrown after all threads have finished.
+ * If the timeout (in seconds, measured from start) is exceeded, the remaining tasks are dropped and TimeoutError is thrown.
+ * If token is cancelled, the remaining tasks are dropped and CancelledError is thrown.
+ */
+static void runTasks(WorkStealingScheduler& scheduler, unsigned int num_tasks, double timeout, Clock::time_point start, CancellationTokenPtr token, const std::function<void(unsigned int, unsigned int)>& process) {
+	std::atomic<unsigned int> finished(0);
+	std::atomic<bool> abort(false);
+	bool timedOut = false;
+	std::exception_ptr error;
+	std::mutex lock; // protects console output, timedOut and error
+
+	std::vector<std::thread> threads;
+	for(unsigned int t = 0; t < scheduler.getNumWorkers(); t++) {
+		threads.push_back(std::thread([&, t]() {
+			try {
+				unsigned int task;
+				while(!abort && scheduler.pop(t, task)) {
+					checkCancelled(token);
+					process(t, task);
+
+					/*
+					 * Check, if we are still in the run time limit
+					 */
+					double runningTime = elapsed(start);
+
+					std::lock_guard<std::mutex> guard(lock);
+					if(timeout > 1 && runningTime > timeout) {  // a timeout of less than a second makes no sense
+						timedOut = true;
+						abort = true;
+					}
+					cout << "finished task " << ++finished << " of " << num_tasks << endl;
+				}
 			}
-			else if(val < -solPrec->getCheckTol()) {
-				helper->setObj(r, -1);
+			catch(...) {
+				std::lock_guard<std::mutex> guard(lock);
+				if(!error) error = std::current_exception();
+				abort = true;
 			}
+		}));
+	}
+	foreach(std::thread& t, threads) {
+		t.join();
+	}
+
+	if(error) {
+		std::rethrow_exception(error);
+	}
+	if(timedOut) {
+		cout << endl;
+		cout << "aborted by timeout of " << timeout << " seconds" << endl;
+		BOOST_THROW_EXCEPTION( TimeoutError() );
+	}
+}
+
+/**
+ * Log of the tasks whose results are final.
+ * Every worker fetches the tasks that were finished since its last fetch, so that it can use the bounds computed by the other workers.
+ */
+class BoundLog : Uncopyable {
+public:
+	BoundLog(unsigned int num_workers) : _fetched(num_workers, 0) {};
+
+	void add(unsigned int task) {
+		std::lock_guard<std::mutex> guard(_lock);
+		_tasks.push_back(task);
+	}
+
+	void fetch(unsigned int worker, vector<unsigned int>& tasks) {
+		std::lock_guard<std::mutex> guard(_lock);
+		tasks.assign(_tasks.begin() + _fetched[worker], _tasks.end());
+		_fetched[worker] = _tasks.size();
+	}
+
+private:
+	std::mutex _lock;
+	vector<unsigned int> _tasks;
+	vector<unsigned int> _fetched; // number of tasks that each worker has already fetched
+};
+
+/**
+ * Stores the outer bounds of bounds in values.
+ */
+static void storeOuterBounds(const unordered_map<ReactionPtr,FVABound >& bounds, unordered_map<ReactionPtr,double >& values) {
+	typedef std::pair<const ReactionPtr, FVABound> Entry;
+	foreach(const Entry& e, bounds) {
+		values[e.first] = e.second.outer;
+	}
+}
+
+/**
+ * Maximizes the objective of model subject to thermodynamic constraints and returns the constraint
+ * that restricts the flux space to the fluxes attaining the given fraction of the optimum (see FVASettings::optimality_fraction).
+ * The optimal flux is added to pool, if pool is not empty.
+ */
+static FluxConstraintPtr computeOptimalityConstraint(ModelPtr model, double fraction, WitnessPoolPtr pool, CancellationTokenPtr token) {
+	FVAThermoModelFactory factory;
+	ScipModelPtr scip = factory.build(model);
+	if(token) {
+		createInterruptEventHandler(scip, token);
+	}
+	scip->solve();
+	checkCancelled(token);
+	if(!scip->isOptimal()) {
+		BOOST_THROW_EXCEPTION( NoOptimumError() );
+	}
+	double opt = scip->getObjectiveValue();
+	cout << "tfba optimum: " << opt << endl;
+
+	FluxConstraintPtr c(new FluxConstraint());
+	foreach(ReactionPtr r, model->getObjectiveReactions()) {
+		c->coef[r] = r->getObj();
+	}
+	// the margin of the check tolerance makes sure that the optimal flux stays feasible despite numerical errors
+	c->lhs = opt - (1 - fraction) * fabs(opt) - model->getFluxPrecision()->getCheckTol();
+
+	if(pool) {
+		vector<double> witness;
+		witness.reserve(pool->getReactions().size());
+		foreach(ReactionPtr r, pool->getReactions()) {
+			witness.push_back(scip->hasFluxVar(r) ? scip->getCurrentFlux(r) : 0);
 		}
-		helper->solve();
-		if(!helper->isFeasible()) { // something strange, abort
-			return false;
-		}
-		if(helper->getObjVal() > helperPrec->getCheckTol()) {
-			double scale = sol->getSubScale(helper);
-			if(scale < -0.5) return false;
-			sol->subtract(helper, scale);
-		}
-#ifndef NDEBUG
-		debugi++;
-		if(debugi % 1000 == 0) std::cout << "FVA.cpp " << __LINE__ << " caught endless loop" << std::endl;
-#endif
-	} while(helper->getObjVal() > helperPrec->getCheckTol());
-	// now we computed a guess of a thermodynamically feasible flow, now we have to check
-	potTest->setDirections(sol);
-	bool result;
-	if(!potTest->testStrictFeasible(result)) {
-		return false;
-	}
-	else return result;
+		pool->add(witness);
+	}
+	return c;
 }
 
-int foo = 0;
+std::string describeResultSettings(ModelPtr model, FVASettingsPtr settings) {
+	// results on the optimal flux space differ from results on the whole flux space
+	ostringstream name;
+	name << setprecision(17) << "tfva";
+	if(settings->optimality_fraction >= 0) {
+		name << "-optimal-" << settings->optimality_fraction;
+
+		// the optimal flux space also depends on the objective, which is not part of hashModel
+		vector<string> coefs;
+		foreach(ReactionPtr r, model->getObjectiveReactions()) {
+			ostringstream coef;
+			coef << setprecision(17) << r->getName() << ":" << r->getObj() << "\n";
+			coefs.push_back(coef.str());
+		}
+		sort(coefs.begin(), coefs.end());
+		string objective;
+		foreach(string& c, coefs) {
+			objective += c;
+		}
+		name << "-obj-" << hashString(objective);
+	}
+	return name.str();
+}
 
 void tfva(ModelPtr model, FVASettingsPtr settings, unordered_map<ReactionPtr,double >& min , unordered_map<ReactionPtr,double >& max ) {
+	string algorithm = describeResultSettings(model, settings);
+
+	FVACachePtr cache;
+	if(!settings->cache.empty()) {
+		cache.reset(new FVACache(settings->cache));
+		if(cache->load(model, algorithm, settings->reactions, min, max)) {
+			return;
+		}
+	}
+
+	unordered_map<ReactionPtr,FVABound > min_bounds, max_bounds;
+	try {
+		tfva(model, settings, min_bounds, max_bounds);
+	}
+	catch(...) {
+		// hand out what we computed so far
+		storeOuterBounds(min_bounds, min);
+		storeOuterBounds(max_bounds, max);
+		throw;
+	}
+	storeOuterBounds(min_bounds, min);
+	storeOuterBounds(max_bounds, max);
+
+	if(cache) {
+		// intervals of an anytime run are valid, but not the exact results
+		typedef std::pair<const ReactionPtr, FVABound> Entry;
+		bool exact = true;
+		foreach(const Entry& e, min_bounds) exact = exact && e.second.status != FVA_BOUNDED;
+		foreach(const Entry& e, max_bounds) exact = exact && e.second.status != FVA_BOUNDED;
+		if(exact) {
+			cache->store(model, algorithm, settings->reactions, min, max);
+		}
+	}
+}
+
+void tfva(ModelPtr model, FVASettingsPtr settings, const FVAModelDiff& diff,
+		const unordered_map<ReactionPtr,double >& prev_min, const unordered_map<ReactionPtr,double >& prev_max,
+		unordered_map<ReactionPtr,double >& min , unordered_map<ReactionPtr,double >& max ) {
+	unordered_set<ReactionPtr> affected;
+	if(settings->optimality_fraction >= 0 && !diff.empty()) {
+		// the edits may change the tFBA optimum, which bounds the fluxes of all reactions through the optimality constraint
+		affected.insert(model->getReactions().begin(), model->getReactions().end());
+	}
+	else {
+		diff.computeAffected(model, prev_min, prev_max, affected);
+	}
+
+	FVASettingsPtr recompute(new FVASettings(*settings));
+	recompute->reactions.clear();
+	recompute->coupling.reset(); // the coupling may not hold anymore for the edited model
+	// a journal holds bounds of the old model, which must not be loaded for the affected reactions
+	recompute->journal.clear();
+	recompute->resume = false;
+	foreach(ReactionPtr r, settings->reactions) {
+		unordered_map<ReactionPtr,double >::const_iterator iter_min = prev_min.find(r);
+		unordered_map<ReactionPtr,double >::const_iterator iter_max = prev_max.find(r);
+		if(affected.find(r) != affected.end() || iter_min == prev_min.end() || iter_max == prev_max.end()) {
+			recompute->reactions.insert(r);
+		}
+		else {
+			min[r] = iter_min->second;
+			max[r] = iter_max->second;
+		}
+	}
+
+	cout << "incremental tfva: recomputing " << recompute->reactions.size() << " of " << settings->reactions.size() << " reactions" << endl;
+	if(!recompute->reactions.empty()) {
+		tfva(model, recompute, min, max);
+	}
+}
+
+void tfva(ModelPtr model, FVASettingsPtr settings, unordered_map<ReactionPtr,FVABound >& min , unordered_map<ReactionPtr,FVABound >& max ) {
 	/*
-	 * Depending on the kind of thermodynamic information given there are different kinds of speedups possible.
-	 * If no potential bounds are given, we just have loopless FVA and we can check if FBA = tFBA by solving two LPs
-	 * In the other case, we basically have to run the cycle elimination heur
+	 * Maximization and minimization of each reaction are separate tasks (task 2*i maximizes reaction i, task 2*i+1 minimizes it).
+	 * The tasks are distributed on the workers by a work stealing scheduler.
+	 * Each worker operates on its own copy of the model with its own LPs and CIPs (see TFVAWorker),
+	 * so the only shared state are the task queues and the preallocated result array,
+	 * where every entry is written by exactly one worker.
 	 */
+	Clock::time_point start = Clock::now();
 
-#define REDUCE_DOMAIN 0
+	if(settings->deterministic) {
+		// everything the workers exchange at run time depends on which worker is faster (see FVASettings::deterministic)
+		FVASettingsPtr fixed(new FVASettings(*settings));
+		fixed->witnesses = 0;
+		fixed->feasibility_cache = 0;
+		fixed->infeasible_sets = 0;
+		fixed->share_coupling = false;
+		fixed->reduce_domain = false;
+		fixed->race_after = -1;
+		settings = fixed;
+	}
+	bool stealing = !settings->deterministic;
 
-	clock_t start = clock();
-	double runningTime = 0;
+	vector<ReactionPtr> reactions(settings->reactions.begin(), settings->reactions.end());
+	orderByLocality(model, reactions);
+	unsigned int num_rxns = reactions.size();
+	unsigned int num_tasks = 2 * num_rxns;
 
-	bool simple = true;
+	unsigned int num_threads = settings->threads > 1 ? settings->threads : 1;
+	if(num_threads > num_tasks) num_threads = num_tasks > 0 ? num_tasks : 1;
 
+	bool simple = true;
 	foreach(MetabolitePtr met, model->getMetabolites()) {
-		if(isinf(met->getPotLb()) == 0) {
-			simple = false;
-		}
-		if(isinf(met->getPotUb()) == 0) {
+		if(isinf(met->getPotLb()) == 0 || isinf(met->getPotUb()) == 0) {
 			simple = false;
 		}
 	}
@@ -250,239 +781,447 @@ void tfva(ModelPtr model, FVASettingsPtr settings, unordered_map<ReactionPtr,dou
 	// TODO: Sometimes it is important that the results computed by FVA are not only valid bounds but also feasible.
 	// in those cases we should check the computed solution for feasibility and if necessary make it feasible.
 
-	// increase dual model flux precision, since we use computation results to add constraints
-	PrecisionPtr orig_precision = model->getFluxPrecision();
-	model->setFluxPrecision(orig_precision->getDualSlavePrecision());
+	/*
+	 * Estimate the cost of each task:
+	 * 2: the direction is contained in an internal cycle, so the LP shortcut is likely to fail
+	 * 1: the opposite direction is contained in a cycle or we have potential bounds that may render the LP solution infeasible
+	 * 0: the LP shortcut will most likely succeed
+	 */
+	unordered_set<DirectedReaction> cycles;
+	findCycleDirections(model, cycles);
 
-	FVAThermoModelFactory factory;
-	factory.coupling = settings->coupling;
+	vector<int> cost(num_tasks, 0);
+	for(unsigned int i = 0; i < num_rxns; i++) {
+		ReactionPtr r = reactions[i];
+		bool fwd = cycles.find(DirectedReaction(r, true)) != cycles.end();
+		bool bwd = cycles.find(DirectedReaction(r, false)) != cycles.end();
+		int base = (!simple && !r->isExchange()) ? 1 : 0;
+		cost[2*i] = fwd ? 2 : (bwd ? 1 : base);
+		cost[2*i+1] = bwd ? 2 : (fwd ? 1 : base);
+	}
 
-	/**
-	 * reset objective functions
-	 */
-	foreach(ReactionPtr a, model->getReactions()) {
-		a->setObj(0);
+	// feasible fluxes found by one worker are start solutions for the CIPs of all workers
+	WitnessPoolPtr pool;
+	if(settings->witnesses > 0) {
+		pool.reset(new WitnessPool(model, settings->witnesses));
 	}
-	foreach(MetabolitePtr a, model->getMetabolites()) {
-		a->setPotObj(0);
+
+	// the feasibility of a sign pattern does not depend on the objective or the flux bounds, so all workers can share the results
+	ThermoFeasibilityCachePtr feasibilityCache;
+	if(settings->feasibility_cache > 0) {
+		feasibilityCache.reset(new ThermoFeasibilityCache(settings->feasibility_cache));
 	}
 
-	/*
-	 * for the cases where it is sufficient to run an LP, we just run an LP
-	 *
-	 * We will maximize fluxes and minimizes fluxes in parallel.
-	 * This way we can exploit that we do not need to solve CPs for reactions which are already fixed by LP
-	 * We use two different LPs for it, so that we don't have to change the objective too much.
-	 */
-	LPFluxPtr max_flux(new LPFlux(model, true));
-	LPFluxPtr min_flux(new LPFlux(model, true));
+	// likewise, infeasible sets do not depend on the objective, so every set found by one CIP can cut off solutions of all later CIPs
+	SharedInfeasibleSetPoolPtr infeasibleSets;
+	if(settings->infeasible_sets > 0) {
+		infeasibleSets.reset(new SharedInfeasibleSetPool(model, settings->infeasible_sets));
+	}
 
-	// the helper flux is used to test if the LP solution is already optimal
-	LPFluxPtr helper(new LPFlux(model, false));
-	helper->setObjSense(true);
+	// couplings learned by presolving one CIP are valid for all CIPs, if presolving does not use the objective (see TFVAWorker)
+	SharedCouplingPtr sharedCoupling;
+	if(settings->share_coupling) {
+		sharedCoupling.reset(new SharedCoupling());
+	}
 
-	// helper needs more precision, since it is called iteratively to remove loops
-	helper->setPrecision(model->getFluxPrecision()->getPrimalSlavePrecision());
-	// for all the other cases we just use model precision, i.e.
-	PrecisionPtr prec = model->getFluxPrecision();
+	// the tFBA optimum and its flux are computed once, every worker adds the objective constraint to its own LPs and CIPs
+	FluxConstraintPtr optimality;
+	if(settings->optimality_fraction >= 0) {
+		optimality = computeOptimalityConstraint(model, settings->optimality_fraction, pool, settings->cancellation);
+	}
 
-	LPPotentialsPtr potTest;
-	if(!simple) {
-		potTest = LPPotentialsPtr(new LPPotentials(model));
+	vector<TFVAWorkerPtr> workers;
+	for(unsigned int t = 0; t < num_threads; t++) {
+		workers.push_back(TFVAWorkerPtr(new TFVAWorker(model, reactions, settings, pool, feasibilityCache, infeasibleSets, sharedCoupling)));
+		if(optimality) {
+			workers.back()->addFluxConstraint(optimality);
+		}
 	}
 
-	max_flux->setObjSense(true);
-	min_flux->setObjSense(false);
+	vector<FVABound> result(num_tasks);
+	vector<char> done(num_tasks, false); // result[task] is final
+
+	/*
+	 * Reactions whose fluxes are tied by a fixed ratio need only be solved once per class,
+	 * the bounds of the other reactions of the class are derived from the bounds of the representative.
+	 */
+	vector<unsigned int> rep;
+	vector<double> ratio;
+	findRatioClasses(model, reactions, rep, ratio);
+	unsigned int num_derived = 0;
+	for(unsigned int i = 0; i < num_rxns; i++) {
+		if(rep[i] != i) num_derived++;
+	}
+	if(num_derived > 0) {
+		cout << "deriving bounds of " << num_derived << " reactions from reactions with fixed flux ratio" << endl;
+	}
+	std::function<bool(unsigned int)> derived = [&](unsigned int task) {
+		return rep[task / 2] != task / 2;
+	};
+	std::function<void()> deriveBounds = [&]() {
+		for(unsigned int i = 0; i < num_rxns; i++) {
+			unsigned int j = rep[i];
+			if(j == i) continue;
+			// with a negative ratio, the maximum is derived from the minimum of the representative and vice versa
+			for(unsigned int task = 2*i; task <= 2*i+1; task++) {
+				unsigned int source = ratio[i] > 0 ? 2*j + task % 2 : 2*j + 1 - task % 2;
+				if(!done[task]) {
+					result[task] = scaleBound(result[source], ratio[i]);
+					done[task] = done[source];
+				}
+			}
+		}
+	};
 
-#if 0
-	stringstream ss;
-	ss << "debug" << ++foo <<".lp";
+	// in anytime mode, the time limit is checked for every task and the run is never aborted
+	bool anytime = settings->anytime;
+	double timeout = anytime ? -1 : settings->timeout;
 
-	SCIPlpiWriteLP(min_flux->getLPI(), ss.str().c_str());
+	/*
+	 * Load the bounds of an aborted run and open the journal
+	 */
+	FVAJournalPtr journal;
+	if(!settings->journal.empty()) {
+		vector<FVAJournal::Entry> entries;
+		if(settings->resume && FVAJournal::load(settings->journal, model, settings, entries)) {
+			// reactions are identified by name, so ignore ambiguous names
+			unordered_map<string, int> index;
+			for(unsigned int i = 0; i < num_rxns; i++) {
+				string name = reactions[i]->getName();
+				index[name] = index.find(name) == index.end() ? (int) i : -1;
+			}
+			int num_resumed = 0;
+			foreach(FVAJournal::Entry& e, entries) {
+				unordered_map<string, int>::iterator iter = index.find(e.reaction);
+				if(iter != index.end() && iter->second >= 0) {
+					unsigned int task = 2 * iter->second + (e.maximize ? 0 : 1);
+					num_resumed += done[task] ? 0 : 1;
+					result[task] = FVABound(e.value, e.status);
+					done[task] = true;
+				}
+			}
+			cout << "resumed " << num_resumed << " of " << num_tasks << " tasks from journal " << settings->journal << endl;
 
-	ss.clear();
-	ss << "debug" << foo << ".map";
+			// the recorded bounds are exact, so use them to tighten the LPs
+			foreach(TFVAWorkerPtr& worker, workers) {
+				for(unsigned int i = 0; i < num_rxns; i++) {
+					if(done[2*i] || done[2*i+1]) {
+						worker->tighten(i, done[2*i+1] ? result[2*i+1].outer : -INFINITY, done[2*i] ? result[2*i].outer : INFINITY);
+					}
+				}
+			}
+		}
+		journal.reset(new FVAJournal(settings->journal, model, settings, !settings->resume));
+	}
 
-	ofstream mapf(ss.str().c_str());
-	mapf << "Reactions" << endl;
-	foreach(ReactionPtr a, model->getReactions()) {
-		mapf << a->getName() << " " << min_flux->getIndex(a) << endl;
+	/*
+	 * A reaction is reported to settings->callback once both of its tasks are reported as final.
+	 * The bounds of derived reactions are reported together with their representative.
+	 */
+	vector<vector<unsigned int> > derivedFrom(num_rxns);
+	for(unsigned int i = 0; i < num_rxns; i++) {
+		if(rep[i] != i) derivedFrom[rep[i]].push_back(i);
 	}
-	mapf << "Metabolites" << endl;
-	foreach(MetabolitePtr a, model->getMetabolites()) {
-		if(!a->hasBoundaryCondition()) {
-			mapf << a->getName() << " " << min_flux->getIndex(a) << endl;
+	std::mutex reportLock;
+	vector<char> reported(num_tasks, false);
+	std::function<void(unsigned int)> report = [&](unsigned int task) {
+		if(!settings->callback) return;
+		std::lock_guard<std::mutex> guard(reportLock);
+		reported[task] = true;
+		unsigned int i = task / 2;
+		if(!reported[task ^ 1]) return;
+		settings->callback(reactions[i], result[2*i+1], result[2*i]);
+		foreach(unsigned int j, derivedFrom[i]) {
+			// same as deriveBounds, but without touching the results that are still in use by the workers
+			FVABound derivedMax = done[2*j] ? result[2*j] : scaleBound(result[ratio[j] > 0 ? 2*i : 2*i+1], ratio[j]);
+			FVABound derivedMin = done[2*j+1] ? result[2*j+1] : scaleBound(result[ratio[j] > 0 ? 2*i+1 : 2*i], ratio[j]);
+			settings->callback(reactions[j], derivedMin, derivedMax);
 		}
-	}
-	mapf.close();
-#endif
+	};
 
-	int i = 1;
-	int num_rxns = settings->reactions.size();
+	/*
+	 * If a direction is blocked (its optimum is zero), all directions coupled to it are blocked, too (see Coupling).
+	 * Their optimum is zero as well, if the zero flux is feasible.
+	 * The coupled directions are found by following the direct couplings backwards, which covers the transitive closure.
+	 * This graph is built once and only read by the workers, only blockedBy is protected by blockedLock.
+	 */
+	bool useCoupling = false;
+	unordered_map<DirectedReaction, vector<DirectedReaction> > coupledFrom; // for every b, all a with a direct coupling a -> b
+	unordered_map<DirectedReaction, unsigned int> taskOf;
+	if(settings->coupling.use_count() >= 1 && !settings->deterministic) {
+		bool zeroFeasible = true;
+		foreach(ReactionPtr r, model->getReactions()) {
+			if(r->getLb() > 0 || r->getUb() < 0) zeroFeasible = false;
+		}
+		if(optimality && (optimality->lhs > 0 || optimality->rhs < 0)) zeroFeasible = false;
+		if(zeroFeasible) {
+			useCoupling = true;
+			vector<pair<DirectedReaction, DirectedReaction> > direct;
+			settings->coupling->getDirectCouplings(direct);
+			typedef pair<DirectedReaction, DirectedReaction> CouplingEntry;
+			foreach(const CouplingEntry& c, direct) {
+				coupledFrom[c.second].push_back(c.first);
+			}
+			for(unsigned int k = 0; k < num_tasks; k++) {
+				taskOf[DirectedReaction(reactions[k / 2], k % 2 == 0)] = k;
+			}
+		}
+	}
+	double tol = model->getFluxPrecision()->getCheckTol();
+	std::mutex blockedLock;
+	vector<int> blockedBy(num_tasks, -1); // a final task with optimum zero that blocks the task
+	std::function<void(unsigned int)> propagateBlocked = [&](unsigned int task) {
+		if(!useCoupling || result[task].outer > tol || result[task].outer < -tol) return;
 
-	foreach(ReactionPtr a, settings->reactions) {
-		/*
-		 * First solve the LPs
-		 */
-		a->setObj(1);
-		cout << "max " << a->getName() << endl;
-		max_flux->setObj(a,1);
-		max_flux->solvePrimal();
-#ifndef NDEBUG
-		if(max_flux->isOptimal()) {
-			cout << "opt-flux = " << max_flux->getObjVal() << endl;
+		// collect the tasks of all directions coupled to the blocked direction
+		vector<unsigned int> coupled;
+		unordered_set<DirectedReaction> visited;
+		std::deque<DirectedReaction> queue;
+		DirectedReaction d(reactions[task / 2], task % 2 == 0);
+		visited.insert(d);
+		queue.push_back(d);
+		while(!queue.empty()) {
+			DirectedReaction b = queue.front();
+			queue.pop_front();
+			unordered_map<DirectedReaction, unsigned int>::const_iterator t = taskOf.find(b);
+			if(t != taskOf.end() && t->second != task) {
+				coupled.push_back(t->second);
+			}
+			unordered_map<DirectedReaction, vector<DirectedReaction> >::const_iterator iter = coupledFrom.find(b);
+			if(iter == coupledFrom.end()) continue;
+			foreach(const DirectedReaction& a, iter->second) {
+				if(visited.insert(a).second) queue.push_back(a);
+			}
 		}
-#endif
 
-		cout << "min " << a->getName() << endl;
-		min_flux->setObj(a,1);
-		min_flux->solvePrimal();
-#ifndef NDEBUG
-		if(min_flux->isOptimal()) {
-			cout << "opt-flux = " << min_flux->getObjVal() << endl;
+		std::lock_guard<std::mutex> guard(blockedLock);
+		foreach(unsigned int k, coupled) {
+			if(blockedBy[k] < 0) blockedBy[k] = task;
 		}
-#endif
+	};
+	std::function<bool(unsigned int)> settleBlocked = [&](unsigned int task) {
+		if(!useCoupling) return false;
+		int source;
+		{
+			std::lock_guard<std::mutex> guard(blockedLock);
+			source = blockedBy[task];
+		}
+		if(source < 0) return false;
+		result[task] = FVABound(0, result[source].status);
+		done[task] = true;
+		if(journal) journal->record(reactions[task / 2], task % 2 == 0, 0, result[task].status);
+		report(task);
+		return true;
+	};
+	for(unsigned int task = 0; task < num_tasks; task++) {
+		if(done[task]) propagateBlocked(task);
+		if(done[task] && !derived(task)) report(task);
+	}
 
-		if(max_flux->isFeasible() && min_flux->isFeasible() && max_flux->getObjVal() - min_flux->getObjVal() < prec->getCheckTol()) {
-			// both fluxes are feasible and the same, hence they also must be optimal
-			max[a] = max_flux->getObjVal();
-			min[a] = min_flux->getObjVal();
+	/*
+	 * With settings->reduce_domain, every final result is used by all workers to tighten their domains before they start their next task.
+	 * The result is written before the task is logged, so the log lock makes sure that other workers see the final value.
+	 */
+	BoundLog log(num_threads);
+	std::function<void(unsigned int)> applyBounds = [&](unsigned int t) {
+		vector<unsigned int> tasks;
+		log.fetch(t, tasks);
+		foreach(unsigned int task, tasks) {
+			bool maximize = task % 2 == 0;
+			workers[t]->tighten(task / 2, maximize ? -INFINITY : result[task].outer, maximize ? result[task].outer : INFINITY);
 		}
-		else {
-			// we were not able to derive that we already found the optimum, so deal with min and max separately
+	};
 
+	try {
+		if(!settings->pipeline && !anytime) {
 			/*
-			 * Maximization
+			 * Reactions are started in order of decreasing cost; both tasks of a reaction are queued at the same worker,
+			 * so that the tightened LP bounds of the first task can be used by the second, unless it gets stolen.
 			 */
-
-			// for shortcut looplessflux must always be attainable
-			// if it is simple, it is sufficient, else we have to do more
-			if(max_flux->isOptimal() && isLooplessFluxAttainable(max_flux, helper) && (simple || isThermoFluxAttainable(max_flux, helper, potTest))) {
-				max[a] = max_flux->getObjVal();
+			vector<pair<int, unsigned int> > order; // (-cost, reaction index), so that sorting yields decreasing cost
+			for(unsigned int i = 0; i < num_rxns; i++) {
+				order.push_back(make_pair(-std::max(cost[2*i], cost[2*i+1]), i));
 			}
-			else {
-				ScipModelPtr scip = factory.build(model);
-				if(settings->timeout > 1) { // a timeout of less than a second makes no sense
-					BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", settings->timeout) );
+			std::sort(order.begin(), order.end());
+
+			WorkStealingScheduler scheduler(num_threads, stealing);
+			unsigned int num_open = 0;
+			for(unsigned int k = 0; k < order.size(); k++) {
+				unsigned int i = order[k].second;
+				if(rep[i] != i) continue;
+				unsigned int first = cost[2*i] >= cost[2*i+1] ? 2*i : 2*i+1;
+				if(!done[first]) {
+					scheduler.push(k % num_threads, first);
+					num_open++;
 				}
-				scip->setObjectiveSense(true);
-				scip->solve();
-
-#ifndef NDEBUG
-				if(!scip->isOptimal()) {
-					SCIPprintStatistics(scip->getScip(), NULL);
-					cout << "LP primal infeasible = " << SCIPlpiIsPrimalInfeasible(max_flux->getLPI()) << endl;
-					if( SCIPlpiHasDualRay(max_flux->getLPI())) {
-						double dualfarkas[model->getMetabolites().size()];
-						SCIPlpiGetDualfarkas(max_flux->getLPI(), dualfarkas);
-						foreach(MetabolitePtr met, model->getMetabolites()) {
-							double d = dualfarkas[max_flux->getIndex(met)];
-							if(d < -prec->getDualFeasTol() || d > prec->getDualFeasTol()) {
-								cout << met->getName() << " = " << d << endl;
-							}
-						}
-					}
-					else {
-						cout << "no dual ray available" << endl;
-					}
-					SCIPwriteOrigProblem(scip->getScip(), "debug.lp", NULL, TRUE);
+				if(!done[first ^ 1]) {
+					scheduler.push(k % num_threads, first ^ 1);
+					num_open++;
 				}
-#endif
-				assert(scip->isOptimal());
-				double opt = scip->getObjectiveValue();
-				max[a] = opt;
-#if REDUCE_DOMAIN
-				a->setUb(opt); // we computed an upper bound, so use it for future computations
-#endif
 			}
 
+			runTasks(scheduler, num_open, timeout, start, settings->cancellation, [&](unsigned int t, unsigned int task) {
+				if(settleBlocked(task)) {
+					if(settings->reduce_domain) log.add(task);
+					return;
+				}
+				if(settings->reduce_domain) applyBounds(t);
+				FVABound bound = workers[t]->solve(task / 2, task % 2 == 0);
+				if(bound.status == FVA_BOUNDED) {
+					// the CIP hit the overall time limit, so the bound is not exact and must neither be journaled nor reported
+					BOOST_THROW_EXCEPTION( TimeoutError() );
+				}
+				result[task] = bound;
+				done[task] = true;
+				if(settings->reduce_domain) log.add(task);
+				if(journal) journal->record(reactions[task / 2], task % 2 == 0, bound.outer, bound.status);
+				report(task);
+				propagateBlocked(task);
+			});
+		}
+		else {
 			/*
-			 * Minimization
+			 * Phase one: solve the LPs of all tasks and check if the LP optimum is already thermodynamically feasible.
+			 * Unsettled tasks keep the LP optimum as bound.
+			 * In anytime mode, tasks that cannot be started in time keep the flux bounds of the model.
 			 */
-
-			// for shortcut looplessflux must always be attainable
-			// if it is simple, it is sufficient, else we have to do more
-			if(min_flux->isOptimal() && isLooplessFluxAttainable(min_flux, helper) && (simple || isThermoFluxAttainable(min_flux, helper, potTest))) {
-				min[a] = min_flux->getObjVal();
-			}
-			else {
-				ScipModelPtr scip = factory.build(model);
-				if(settings->timeout > 1) { // a timeout of less than a second makes no sense
-					BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", settings->timeout) );
+			{
+				WorkStealingScheduler scheduler(num_threads, stealing);
+				unsigned int num_open = 0;
+				// every worker gets a contiguous block of the locality order
+				for(unsigned int task = 0; task < num_tasks; task++) {
+					if(!done[task] && !derived(task)) {
+						scheduler.push(((unsigned long) task * num_threads) / num_tasks, task);
+						num_open++;
+					}
 				}
-				scip->setObjectiveSense(false);
-				scip->solve();
-#ifndef NDEBUG
-				if(!scip->isOptimal()) {
-					SCIPprintStatistics(scip->getScip(), NULL);
-					cout << "LP primal infeasible = " << SCIPlpiIsPrimalInfeasible(min_flux->getLPI()) << endl;
-					if( SCIPlpiHasDualRay(min_flux->getLPI())) {
-						double dualfarkas[model->getMetabolites().size()];
-						SCIPlpiGetDualfarkas(min_flux->getLPI(), dualfarkas);
-						foreach(MetabolitePtr met, model->getMetabolites()) {
-							double d = dualfarkas[min_flux->getIndex(met)];
-							if(d < -prec->getDualFeasTol() || d > prec->getDualFeasTol()) {
-								cout << met->getName() << " = " << d << endl;
-							}
-						}
+				runTasks(scheduler, num_open, timeout, start, settings->cancellation, [&](unsigned int t, unsigned int task) {
+					bool maximize = task % 2 == 0;
+					ReactionPtr r = reactions[task / 2];
+					FVABound& bound = result[task];
+					bound.status = FVA_BOUNDED;
+					bound.outer = maximize ? r->getUb() : r->getLb();
+					bound.inner = maximize ? -INFINITY : INFINITY;
+					if(anytime && settings->timeout > 1 && elapsed(start) > settings->timeout) {
+						return;
+					}
+					if(settleBlocked(task)) return;
+
+					double value;
+					if(workers[t]->screen(task / 2, maximize, value)) {
+						bound = FVABound(value, FVA_LP);
+						done[task] = true;
+						if(journal) journal->record(r, maximize, value, FVA_LP);
+						report(task);
+						propagateBlocked(task);
 					}
 					else {
-						cout << "no dual ray available" << endl;
+						bound.outer = maximize ? std::min(bound.outer, value) : std::max(bound.outer, value);
 					}
-					SCIPwriteOrigProblem(scip->getScip(), "debug.lp", NULL, TRUE);
+				});
+			}
+
+			/*
+			 * The LP optima are valid bounds for the thermodynamically feasible fluxes,
+			 * so every worker can use them to tighten the domains before building any CIP.
+			 */
+			deriveBounds();
+			foreach(TFVAWorkerPtr& worker, workers) {
+				for(unsigned int i = 0; i < num_rxns; i++) {
+					worker->tighten(i, result[2*i+1].outer, result[2*i].outer);
 				}
-#endif
-				assert(scip->isOptimal());
-				double opt = scip->getObjectiveValue();
-				min[a] = opt;
-#if REDUCE_DOMAIN
-				a->setLb(opt); // we computed a lower bound, so use it for future computations
-#endif
 			}
 
 			/*
-			 * Actually, we are now adding constraints and not decrease the precision.
-			 * This ok, since we solve with high dual precision.
-			 * This means, the error that we do is rather in primal infeasibilities than in dual infeasibilities,
-			 * i.e. the bounds that we compute tend to be a bit weaker.
-			 * In particular it is unlikely that they are overtight and produce infeasibilities.
+			 * Phase two: solve CIPs for the remaining tasks, most expensive first.
 			 */
-			double maxflux = max[a];
-			double minflux = min[a];
-			//double maxflux = maxf > minf ? maxf : minf;
-			//double minflux = maxf > minf ? minf : maxf;
-			max_flux->setUb(a, maxflux);
-			min_flux->setUb(a, maxflux);
-			max_flux->setLb(a, minflux);
-			min_flux->setLb(a, minflux);
-			max_flux->solveDual();
-			min_flux->solveDual();
-		}
-		/*
-		 * reset objective function
-		 */
-		max_flux->setObj(a,0);
-		min_flux->setObj(a,0);
+			vector<pair<int, unsigned int> > order; // (-cost, task)
+			for(unsigned int task = 0; task < num_tasks; task++) {
+				if(!done[task] && !derived(task)) {
+					order.push_back(make_pair(-cost[task], task));
+				}
+			}
+			std::sort(order.begin(), order.end());
 
-		a->setObj(0);
+			cout << "LP screening settled " << num_tasks - order.size() << " of " << num_tasks << " tasks, " << order.size() << " CIPs remaining" << endl;
 
-		/*
-		 * Check, if we are still in the run time limit
-		 */
-		runningTime = (double) (clock() - start) / CLOCKS_PER_SEC;
+			WorkStealingScheduler scheduler(num_threads, stealing);
+			for(unsigned int k = 0; k < order.size(); k++) {
+				scheduler.push(k % num_threads, order[k].second);
+			}
+			runTasks(scheduler, order.size(), timeout, start, settings->cancellation, [&](unsigned int t, unsigned int task) {
+				bool maximize = task % 2 == 0;
+				double limit = settings->timeout;
+				if(anytime) {
+					// every CIP gets its own budget, but we never run beyond the overall timeout
+					limit = settings->cip_timeout;
+					if(settings->timeout > 1) {
+						double remaining = settings->timeout - elapsed(start);
+						if(remaining < 1) return; // keep the LP bound
+						if(limit <= 1 || remaining < limit) limit = remaining;
+					}
+				}
+				else if(settings->timeout > 1) {
+					// the CIP only gets the time that is left of the overall timeout
+					limit = settings->timeout - elapsed(start);
+					if(limit < 1) BOOST_THROW_EXCEPTION( TimeoutError() );
+				}
 
-		if(settings->timeout > 1 && runningTime > settings->timeout) {  // a timeout of less than a second makes no sense
-			cout << endl;
-			cout << "aborted by timeout of " << settings->timeout << " seconds" << endl;
-			BOOST_THROW_EXCEPTION( TimeoutError() );
+				if(settleBlocked(task)) {
+					if(settings->reduce_domain) log.add(task);
+					return;
+				}
+				if(settings->reduce_domain) applyBounds(t);
+				FVABound bound = workers[t]->solveCIP(task / 2, maximize, limit, result[task].outer);
+				if(bound.status == FVA_CIP) {
+					result[task] = bound;
+					done[task] = true;
+					if(settings->reduce_domain) log.add(task);
+					if(journal) journal->record(reactions[task / 2], maximize, bound.outer, FVA_CIP);
+					report(task);
+					propagateBlocked(task);
+				}
+				else if(!anytime) {
+					// the CIP hit the overall time limit, so the bound is not exact and must neither be journaled nor reported
+					BOOST_THROW_EXCEPTION( TimeoutError() );
+				}
+				else {
+					// the LP optimum may still be the better outer bound
+					FVABound& old = result[task];
+					old.outer = maximize ? std::min(old.outer, bound.outer) : std::max(old.outer, bound.outer);
+					old.inner = bound.inner;
+				}
+			});
 		}
+	}
+	catch(...) {
+		// hand out what we computed so far
+		deriveBounds();
+		for(unsigned int task = 0; task < num_tasks; task++) {
+			if(done[task]) {
+				(task % 2 == 0 ? max : min)[reactions[task / 2]] = result[task];
+			}
+		}
+		throw;
+	}
+	deriveBounds();
 
-		cout << "finished iteration " << i << " of " << num_rxns << endl;
-		i++;
+	// the bounds that are not exact are final now
+	for(unsigned int task = 0; task < num_tasks; task++) {
+		if(!reported[task] && !derived(task)) report(task);
 	}
 
-	// reset precision
-	model->setFluxPrecision(orig_precision);
+	for(unsigned int i = 0; i < num_rxns; i++) {
+		max[reactions[i]] = result[2*i];
+		min[reactions[i]] = result[2*i+1];
+	}
+
+	if(anytime) {
+		unsigned int num_bounded = num_tasks - std::count(done.begin(), done.end(), true);
+		if(num_bounded > 0) {
+			cout << num_bounded << " of " << num_tasks << " bounds could not be computed exactly in time, reporting intervals" << endl;
+		}
+	}
 }
 
 
@@ -28,42 +28,117 @@
 
 #include <boost/unordered_map.hpp>
 #include <utility>
+#include <string>
+#include <functional>
 
 #include "model/Model.h"
 #include "model/scip/LPFlux.h"
 
 #include "algorithms/ModelFactory.h"
 #include "model/Coupling.h"
+#include "CancellationToken.h"
 #include "Properties.h"
 
 namespace metaopt {
 
+/**
+ * Describes how a bound computed by tfva was obtained.
+ */
+enum FVAStatus {
+	FVA_LP = 0, /** the LP optimum is thermodynamically feasible */
+	FVA_CIP = 1, /** the CIP was solved to optimality */
+	FVA_BOUNDED = 2 /** the computation was stopped early, only an interval containing the optimum is known (see FVABound) */
+};
+
+/**
+ * A bound computed by tfva.
+ *
+ * The optimal thermodynamically feasible flux lies between inner and outer.
+ * For maximization, outer is an upper bound (e.g. the SCIP dual bound or the LP optimum)
+ * and inner is the flux of the best thermodynamically feasible solution found.
+ * For minimization it is the other way around.
+ * If no feasible solution was found, inner is -INFINITY for maximization and INFINITY for minimization.
+ * If the status is FVA_LP or FVA_CIP, inner and outer coincide.
+ */
+struct FVABound {
+	double outer;
+	double inner;
+	FVAStatus status;
+
+	FVABound() : outer(0), inner(0), status(FVA_BOUNDED) {};
+	FVABound(double value, FVAStatus status) : outer(value), inner(value), status(status) {};
+};
+
+/**
+ * Receives the bounds of a reaction as soon as both of them are final (see FVASettings::callback).
+ */
+typedef std::function<void(ReactionPtr reaction, const FVABound& min, const FVABound& max)> FVAResultCallback;
+
 struct FVASettings {
 	double timeout;
 	boost::unordered_set<ReactionPtr> reactions;
 	CouplingPtr coupling;
+	int threads; // number of worker threads used by tfva
+	bool pipeline; // first screen all reactions by LP, then solve the remaining CIPs (see tfva)
+	std::string journal; // if not empty, every computed bound is recorded in this file (see FVAJournal)
+	bool resume; // continue the run recorded in journal instead of starting from scratch
+	bool anytime; // do not abort on timeout, but report intervals for the unfinished bounds (see tfva)
+	double cip_timeout; // in anytime mode, the time limit for a single CIP (-1 for no limit besides timeout)
+	bool persistent; // every worker builds only one CIP and resolves it for all reactions (see TFVAWorker)
+	int witnesses; // number of feasible fluxes kept as start solutions for later CIPs (see WitnessPool), 0 disables
+	bool reduce_domain; // use every computed bound to tighten the flux bounds of all later CIPs (see TFVAWorker::tighten)
+	std::string cache; // if not empty, results are looked up in and stored to the FVACache in this directory
+	int feasibility_cache; // number of reaction sign patterns whose thermodynamic feasibility is shared by all workers (see ThermoFeasibilityCache), 0 disables
+	int infeasible_sets; // number of infeasible sets shared by all CIPs of a tfva run (see SharedInfeasibleSetPool), 0 disables
+	bool share_coupling; // collect the couplings learned in presolving by all CIPs of a tfva run (see SharedCoupling)
+	double race_after; // seconds after which an alternative formulation is raced against a CIP (see TFVAWorker), -1 disables
+	double optimality_fraction; // only analyze the fluxes attaining this fraction of the tFBA optimum of the model objective (see tfva), -1 analyzes all fluxes
+	bool deterministic; // make the schedule and the information flow of tfva independent of the run times of the workers, at the expense of speed (see tfva)
+	FVAResultCallback callback; // if set, called by tfva for every reaction as soon as its bounds are final (see tfva)
+	CancellationTokenPtr cancellation; // if set, fva and tfva stop soon after it is cancelled and throw a CancelledError
 
-	FVASettings() : timeout(-1), reactions() {};
+	FVASettings() : timeout(-1), reactions(), threads(1), pipeline(false), journal(), resume(false), anytime(false), cip_timeout(-1), persistent(false), witnesses(0), reduce_domain(false), cache(), feasibility_cache(0), infeasible_sets(0), share_coupling(false), race_after(-1), optimality_fraction(-1), deterministic(false) {};
 };
 
 typedef boost::shared_ptr<FVASettings> FVASettingsPtr;
 
 /**
  * Runs ordinary flux variablity analysis on the given model. The objective coefficients are ignored, the whole flux space is analyzed.
+ * The reactions are split on the given number of threads (see below).
  * Result is stored in the maps min and max. min contains the minimal possible flux, max contains the maximal possible flux.
  * If min,max are not empty, existing values may be overridden.
+ * If token is given and cancelled, the computation stops before the next LP and throws a CancelledError.
+ */
+void fva(ModelPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max, unsigned int threads = 1, CancellationTokenPtr token = CancellationTokenPtr());
+
+/**
+ * Runs ordinary flux variablity analysis on all reactions of the given model with settings->threads threads.
+ * If settings->cache is set, the results are taken from the cache if possible, and stored in the cache otherwise.
+ * The reactions are always split into fixed blocks, so the results are reproducible for the same number of threads without settings->deterministic.
+ * Other settings are ignored.
  */
-void fva(ModelPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max );
+void fva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max );
 
 /**
  * Runs ordinary flux variability analysis on the given LPFlux model.
  * Objective coefficients of model must be zero initially and will be zero afterwards.
  * The objective sense will be set to maximize.
+ * The reactions are solved in an order where consecutive reactions are close in the network, so that warm starts pay off.
+ * Reactions that carry flux at their bounds in any computed LP solution are not solved separately,
+ * and LPs maximizing (minimizing) the sum of all open reactions are used to settle many reactions at once.
  * Result is stored in the maps min and max. min contains the minimal possible flux, max contains the maximal possible flux.
  * If min,max are not empty, existing values may be overridden.
  */
 void fva(LPFluxPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max );
 
+/**
+ * Runs ordinary flux variability analysis on the given LPFlux model with the given number of threads.
+ * The reactions are split into contiguous blocks, and every thread solves its block on its own copy of the LP (see LPFlux::copy).
+ * Otherwise, this behaves like the serial version above.
+ * If token is given and cancelled, all threads stop before their next LP and a CancelledError is thrown.
+ */
+void fva(LPFluxPtr model, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max, unsigned int threads, CancellationTokenPtr token = CancellationTokenPtr());
+
 /**
  * Runs flux variability on the given model.
  * Additional constraints, like thermodynamic constraints can be given via the model factory.
@@ -73,6 +148,62 @@ void fva(ModelPtr model, ModelFactory& factory, boost::unordered_map<ReactionPtr
 
 /**
  * Runs thermodynamic FVA on the given model.
+ * The reactions are processed by settings->threads workers in parallel.
+ * Every worker operates on its own copy of the model, so model is not modified.
+ * The timeout is measured in wall clock time.
+ * The reactions are processed in a deterministic order where consecutive reactions share metabolites, so that warm starts pay off.
+ *
+ * If settings->pipeline is set, the computation runs in two phases:
+ * First, the LPs of all reactions are solved and it is checked if the LP optimum is thermodynamically feasible.
+ * Then, the LP optima are used to tighten the flux bounds and CIPs are solved only for the remaining directions.
+ *
+ * If settings->reduce_domain is set, every computed bound is used to tighten the flux bounds for all later computations of all workers.
+ * This only affects the copies of the workers and shrinks the LP relaxations and branch and bound trees of later CIPs.
+ *
+ * Reactions whose fluxes are tied by a fixed ratio (because they share a metabolite that is involved in no other reaction)
+ * are solved only once per class, the bounds of the other reactions are derived from the ratio.
+ * If settings->coupling is given and the zero flux is feasible, every direction coupled to a blocked direction is settled as blocked without solving.
+ *
+ * If settings->journal is set, every computed bound is appended to the journal.
+ * With settings->resume, the bounds recorded in the journal are loaded and only the missing bounds are computed.
+ * A journal of a different model, different settings or different tolerances is refused with a JournalError.
+ * If the computation is aborted (for example by a TimeoutError), min and max contain the bounds computed so far.
+ *
+ * If settings->cache is set, the results are taken from the cache if possible (see FVACache).
+ * Otherwise, they are stored in the cache if all bounds could be computed exactly.
+ *
+ * If settings->anytime is set, tfva runs in pipeline mode and does not abort on timeout.
+ * Every CIP is solved with the time limit settings->cip_timeout (and never beyond settings->timeout).
+ * If a CIP is stopped early or could not be started in time, the best known bounds are reported with status FVA_BOUNDED.
+ * In this overload, only the outer bound is stored, which is still a valid bound on the thermodynamically feasible flux.
+ *
+ * If settings->optimality_fraction is set, tfva first maximizes the objective of the model subject to thermodynamic constraints (tFBA).
+ * Then, only the fluxes whose objective value attains the given fraction of the optimum are analyzed
+ * (for a negative optimum, the objective value may fall short of the optimum by the corresponding fraction of its absolute value).
+ * The objective constraint is added to the LPs and CIPs of all workers, and the tFBA solution is used as start solution.
+ * If the tFBA problem has no finite optimum, a NoOptimumError is thrown.
+ *
+ * If settings->deterministic is set, the computation of every worker does not depend on the run times of the other workers,
+ * so with the same number of threads every worker solves the same tasks in the same order from the same starting state:
+ * Tasks are assigned to the workers by a fixed schedule without stealing, every worker resets the warm start of its LPs before each task,
+ * and all information that workers exchange at run time is switched off (witnesses, feasibility cache, shared infeasible sets and couplings,
+ * reduce_domain, racing and settling directions coupled to blocked directions), since it depends on which worker is faster.
+ * This does not guarantee bitwise identical results across runs: the model stores its reactions and metabolites in hash sets keyed by pointers,
+ * so the order of the LP columns and SCIP variables of the worker copies may change from run to run,
+ * which may lead to different rounding in the solvers. Time limits (timeout, anytime mode) are another source of differences.
+ * This mode is slower than free scheduling: workers with short queues stay idle until the longest queue is processed,
+ * which hurts most on models where a few hard CIPs dominate the run time, every LP is solved from scratch,
+ * and the savings of the shared information are lost.
+ *
+ * If settings->callback is set, it is called for every reaction of settings->reactions as soon as both of its bounds are final,
+ * from the thread that finished the last of them. Calls are serialized, so the callback needs no synchronization of its own,
+ * but it blocks the calling worker and should return quickly. Bounds that are not exact (e.g. intervals of an anytime run)
+ * are reported when the run completes. If the run is aborted, the remaining reactions are not reported.
+ * If the callback throws, the run is aborted and the exception is rethrown.
+ *
+ * If settings->cancellation is set and gets cancelled (from any thread), every worker stops at its next task, LP of the cycle check
+ * or node of the running CIP, and a CancelledError is thrown once all workers have finished. Results recorded in the journal remain valid,
+ * so a cancelled run can be resumed.
  * @param model the model to solve thermodynamic FVA on
  * @param reactions the reactions for which to do FVA
  * @param min minimal flux values
@@ -80,9 +211,46 @@ void fva(ModelPtr model, ModelFactory& factory, boost::unordered_map<ReactionPtr
  */
 void tfva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max );
 
+/**
+ * Runs thermodynamic FVA on the given model and reports how each bound was obtained.
+ * In anytime mode (settings->anytime), every reaction gets an interval for its minimal and its maximal flux, even if the time runs out.
+ * Otherwise, see the overload above.
+ */
+void tfva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<ReactionPtr,FVABound >& min , boost::unordered_map<ReactionPtr,FVABound >& max );
+
+/**
+ * Describes the settings that influence the results of tfva (e.g. settings->optimality_fraction) in a canonical string without white spaces.
+ * If the flux space is restricted to (nearly) optimal fluxes, it also covers the objective of the model, because hashModel does not.
+ * It is the key of tfva results in the FVACache and is recorded in result files (see FVAResultFile),
+ * so that results of different problems are never mixed up.
+ * Settings that only influence how the results are computed (e.g. threads) are not included.
+ */
+std::string describeResultSettings(ModelPtr model, FVASettingsPtr settings);
+
+class FVAModelDiff;
+
+/**
+ * Reruns thermodynamic FVA after small edits of the model, which are recorded in diff (see FVAModelDiff).
+ * prev_min and prev_max are the results of the run before the edits.
+ *
+ * Only the reactions of settings->reactions that may be influenced by the edits (see FVAModelDiff::computeAffected)
+ * or that have no previous result are recomputed by tfva, the previous results of the other reactions are copied.
+ * If the run is restricted to the optimal flux space (settings->optimality_fraction), any edit may change the optimum,
+ * so all reactions are recomputed.
+ * The coupling in settings belongs to the old model, so it is not used for the recomputation.
+ * Neither is settings->journal, because its bounds belong to the old model, too.
+ * settings->callback is only called for the recomputed reactions, the copied results are only stored in min and max.
+ */
+void tfva(ModelPtr model, FVASettingsPtr settings, const FVAModelDiff& diff,
+		const boost::unordered_map<ReactionPtr,double >& prev_min, const boost::unordered_map<ReactionPtr,double >& prev_max,
+		boost::unordered_map<ReactionPtr,double >& min , boost::unordered_map<ReactionPtr,double >& max );
+
 /** Used if an reaction is not found */
 struct TimeoutError : virtual boost::exception, virtual std::exception {};
 
+/** Thrown if tfva is restricted to the optimal flux space, but the objective has no finite optimum (see FVASettings::optimality_fraction) */
+struct NoOptimumError : virtual boost::exception, virtual std::exception {};
+
 
 } /* namespace metaopt */
 #endif /* FVA_H_ */
@@ -0,0 +1,79 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAAsync.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <chrono>
+
+#include "FVAAsync.h"
+
+namespace metaopt {
+
+FVAHandle::FVAHandle(unsigned int total) : _finished(new std::atomic<unsigned int>(0)), _total(total) {
+	// nothing to do
+}
+
+std::shared_future<FVAResultPtr> FVAHandle::getResult() const {
+	return _result;
+}
+
+void FVAHandle::wait() const {
+	_result.wait();
+}
+
+bool FVAHandle::isFinished() const {
+	return _result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+unsigned int FVAHandle::getFinished() const {
+	return _finished->load();
+}
+
+unsigned int FVAHandle::getTotal() const {
+	return _total;
+}
+
+FVAHandlePtr tfvaAsync(ModelPtr model, FVASettingsPtr settings, FVAResultCallback callback) {
+	FVASettingsPtr run(new FVASettings(*settings));
+	FVAHandlePtr handle(new FVAHandle(run->reactions.size()));
+
+	// count the final reactions, the run only refers to the counter, so that it does not keep the handle alive
+	boost::shared_ptr<std::atomic<unsigned int> > finished = handle->_finished;
+	if(!callback) {
+		callback = run->callback;
+	}
+	run->callback = [finished, callback](ReactionPtr reaction, const FVABound& min, const FVABound& max) {
+		if(callback) {
+			callback(reaction, min, max);
+		}
+		(*finished)++;
+	};
+
+	handle->_result = std::async(std::launch::async, [model, run]() {
+		FVAResultPtr result(new FVAResult());
+		tfva(model, run, result->min, result->max);
+		return result;
+	}).share();
+	return handle;
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,106 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAAsync.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FVAASYNC_H_
+#define FVAASYNC_H_
+
+#include <future>
+#include <atomic>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "model/Model.h"
+#include "algorithms/FVA.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * The bounds computed by a tfva run for all of its reactions.
+ */
+struct FVAResult {
+	boost::unordered_map<ReactionPtr, FVABound> min;
+	boost::unordered_map<ReactionPtr, FVABound> max;
+};
+
+typedef boost::shared_ptr<FVAResult> FVAResultPtr;
+
+/**
+ * Handle of a tfva run in the background (see tfvaAsync).
+ *
+ * The run keeps going when the handle is destroyed, the destructor of the last copy of the future waits for it.
+ */
+class FVAHandle : Uncopyable {
+public:
+	/**
+	 * Returns the future of the complete result.
+	 * If the run fails (e.g. by a TimeoutError), the future rethrows the exception on get.
+	 */
+	std::shared_future<FVAResultPtr> getResult() const;
+
+	/**
+	 * Blocks until the run is finished.
+	 */
+	void wait() const;
+
+	/**
+	 * Checks, without blocking, if the run is finished.
+	 */
+	bool isFinished() const;
+
+	/**
+	 * Returns the number of reactions whose bounds are final.
+	 */
+	unsigned int getFinished() const;
+
+	/**
+	 * Returns the number of reactions of the run.
+	 */
+	unsigned int getTotal() const;
+
+private:
+	friend boost::shared_ptr<FVAHandle> tfvaAsync(ModelPtr model, FVASettingsPtr settings, FVAResultCallback callback);
+
+	FVAHandle(unsigned int total);
+
+	boost::shared_ptr<std::atomic<unsigned int> > _finished; // shared with the run, so that it does not depend on the lifetime of the handle
+	unsigned int _total;
+	std::shared_future<FVAResultPtr> _result;
+};
+
+typedef boost::shared_ptr<FVAHandle> FVAHandlePtr;
+
+/**
+ * Starts thermodynamic FVA (see tfva) in a background thread and returns immediately.
+ *
+ * The model must not be modified until the run is finished.
+ * The settings are copied, so they can be changed or reused for other runs.
+ * If callback is set, it receives every reaction as soon as its bounds are final (see FVASettings::callback), it replaces the callback of settings.
+ * As with tfva, progress information is still printed to the console.
+ */
+FVAHandlePtr tfvaAsync(ModelPtr model, FVASettingsPtr settings, FVAResultCallback callback = FVAResultCallback());
+
+} /* namespace metaopt */
+#endif /* FVAASYNC_H_ */
@@ -0,0 +1,146 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVACache.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <boost/exception/diagnostic_information.hpp>
+
+#include "FVACache.h"
+#include "FVAResultFile.h"
+#include "model/ModelHash.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+FVACache::FVACache(std::string directory) : _directory(directory) {
+	// nothing to do
+}
+
+FVACache::~FVACache() {
+	// nothing to do
+}
+
+/**
+ * appends the tolerances of the precision to the stream
+ */
+static void describePrecision(ostream& out, const char* name, PrecisionPtr precision) {
+	out << name << ' ' << precision->getPrimalFeasTol() << ' ' << precision->getDualFeasTol() << ' ' << precision->getCheckTol() << '\n';
+}
+
+std::string FVACache::getFilename(ModelPtr model, std::string algorithm, const unordered_set<ReactionPtr>& reactions) {
+	vector<string> names;
+	foreach(ReactionPtr r, reactions) {
+		names.push_back(r->getName());
+	}
+	std::sort(names.begin(), names.end());
+
+	ostringstream key;
+	key << setprecision(17);
+	key << algorithm << '\n' << VERSION << '\n' << hashModel(model) << '\n';
+	describePrecision(key, "flux", model->getFluxPrecision());
+	describePrecision(key, "pot", model->getPotPrecision());
+	describePrecision(key, "coef", model->getCoefPrecision());
+	foreach(const string& name, names) {
+		key << name << '\n';
+	}
+
+	return _directory + "/" + algorithm + "-" + hashString(key.str()) + ".fva";
+}
+
+bool FVACache::load(ModelPtr model, std::string algorithm, const unordered_set<ReactionPtr>& reactions,
+		unordered_map<ReactionPtr,double >& min, unordered_map<ReactionPtr,double >& max) {
+	string filename = getFilename(model, algorithm, reactions);
+
+	FVAResultFile::Header header;
+	vector<FVAResultFile::Entry> entries;
+	try {
+		FVAResultFile::read(filename, header, entries);
+	}
+	catch(ResultFileError& e) {
+		return false; // usually, the entry does not exist
+	}
+
+	// guard against hash collisions and damaged entries
+	if(header.version != VERSION || header.model != hashModel(model) || header.settings != algorithm || entries.size() != reactions.size()) {
+		return false;
+	}
+	unordered_map<string, ReactionPtr> byName;
+	foreach(ReactionPtr r, reactions) {
+		byName[r->getName()] = r;
+	}
+	unordered_map<ReactionPtr,double > cached_min, cached_max;
+	foreach(const FVAResultFile::Entry& e, entries) {
+		unordered_map<string, ReactionPtr>::iterator iter = byName.find(e.reaction);
+		if(iter == byName.end()) {
+			return false;
+		}
+		cached_min[iter->second] = e.min;
+		cached_max[iter->second] = e.max;
+	}
+	if(cached_min.size() != reactions.size()) {
+		return false;
+	}
+
+	typedef pair<const ReactionPtr, double> BoundEntry;
+	foreach(const BoundEntry& e, cached_min) {
+		min[e.first] = e.second;
+	}
+	foreach(const BoundEntry& e, cached_max) {
+		max[e.first] = e.second;
+	}
+	cout << "loaded " << algorithm << " results from cache " << filename << endl;
+	return true;
+}
+
+void FVACache::store(ModelPtr model, std::string algorithm, const unordered_set<ReactionPtr>& reactions,
+		const unordered_map<ReactionPtr,double >& min, const unordered_map<ReactionPtr,double >& max) {
+	string filename = getFilename(model, algorithm, reactions);
+
+	// only store the requested reactions
+	unordered_map<ReactionPtr,double > stored_min, stored_max;
+	foreach(ReactionPtr r, reactions) {
+		unordered_map<ReactionPtr,double >::const_iterator iter_min = min.find(r);
+		unordered_map<ReactionPtr,double >::const_iterator iter_max = max.find(r);
+		if(iter_min == min.end() || iter_max == max.end()) {
+			return; // incomplete results are never cached
+		}
+		stored_min[r] = iter_min->second;
+		stored_max[r] = iter_max->second;
+	}
+
+	try {
+		FVAResultFile::write(filename, model, algorithm, 0, 1, stored_min, stored_max);
+	}
+	catch(std::exception& e) {
+		cout << "Warning: could not write cache entry " << filename << endl;
+		cout << diagnostic_information(e) << endl;
+	}
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,81 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVACache.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FVACACHE_H_
+#define FVACACHE_H_
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "model/Model.h"
+#include "model/Reaction.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * On-disk cache of FVA results.
+ *
+ * Every entry is a result file (see FVAResultFile) in the cache directory.
+ * Its name is a hash of the model (see hashModel), the precisions of the model, the analyzed reactions,
+ * the algorithm and the program version, so entries never have to be invalidated.
+ * The algorithm includes the settings that influence the results (see describeResultSettings) and is also recorded in the entry.
+ * Entries are written atomically, so several processes may share a cache directory.
+ */
+class FVACache {
+public:
+	/**
+	 * @param directory an existing directory for the cache entries
+	 */
+	FVACache(std::string directory);
+	virtual ~FVACache();
+
+	/**
+	 * Looks up the results of algorithm for the given reactions on the current state of model.
+	 *
+	 * @return true, if the results were found and stored in min and max
+	 */
+	bool load(ModelPtr model, std::string algorithm, const boost::unordered_set<ReactionPtr>& reactions,
+			boost::unordered_map<ReactionPtr,double >& min, boost::unordered_map<ReactionPtr,double >& max);
+
+	/**
+	 * Stores the results of algorithm for the given reactions on the current state of model.
+	 * Errors are reported, but not thrown, since the results are valid anyways.
+	 */
+	void store(ModelPtr model, std::string algorithm, const boost::unordered_set<ReactionPtr>& reactions,
+			const boost::unordered_map<ReactionPtr,double >& min, const boost::unordered_map<ReactionPtr,double >& max);
+
+private:
+	std::string _directory;
+
+	/** returns the file name of the cache entry */
+	std::string getFilename(ModelPtr model, std::string algorithm, const boost::unordered_set<ReactionPtr>& reactions);
+};
+
+typedef boost::shared_ptr<FVACache> FVACachePtr;
+
+} /* namespace metaopt */
+#endif /* FVACACHE_H_ */
@@ -0,0 +1,160 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAJournal.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+#include "FVAJournal.h"
+#include "model/ModelHash.h"
+
+namespace metaopt {
+
+// maximal number of records that are kept in memory
+#define JOURNAL_BATCH_SIZE 32
+// maximal number of seconds records are kept in memory
+#define JOURNAL_SYNC_INTERVAL 10
+
+#define JOURNAL_HEADER "# metaopt tfva journal"
+
+std::string FVAJournal::header(ModelPtr model, FVASettingsPtr settings) {
+	std::ostringstream ss;
+	ss << std::setprecision(17);
+	ss << JOURNAL_HEADER << " " << VERSION << '\n';
+	ss << "# model " << hashModel(model) << '\n';
+	ss << "# settings " << describeResultSettings(model, settings) << '\n';
+	ss << "# flux_tol " << model->getFluxPrecision()->getCheckTol() << '\n';
+	ss << "# pot_tol " << model->getPotPrecision()->getCheckTol() << '\n';
+	return ss.str();
+}
+
+FVAJournal::FVAJournal(std::string filename, ModelPtr model, FVASettingsPtr settings, bool truncate) : _filename(filename), _pending(0) {
+	int flags = O_WRONLY | O_CREAT | O_APPEND;
+	if(truncate) flags |= O_TRUNC;
+	_fd = open(filename.c_str(), flags, 0644);
+	if(_fd < 0) {
+		BOOST_THROW_EXCEPTION( JournalError() << boost::errinfo_errno(errno) << boost::errinfo_file_name(filename) );
+	}
+	if(lseek(_fd, 0, SEEK_END) == 0) {
+		_buffer = header(model, settings);
+		write();
+	}
+	_lastSync = std::chrono::steady_clock::now();
+}
+
+FVAJournal::~FVAJournal() {
+	try {
+		flush();
+	}
+	catch(...) {
+		// destructors must not throw, the records are lost
+	}
+	close(_fd);
+}
+
+void FVAJournal::write() {
+	const char* data = _buffer.data();
+	size_t remaining = _buffer.size();
+	while(remaining > 0) {
+		ssize_t n = ::write(_fd, data, remaining);
+		if(n < 0) {
+			if(errno == EINTR) continue;
+			BOOST_THROW_EXCEPTION( JournalError() << boost::errinfo_errno(errno) << boost::errinfo_file_name(_filename) );
+		}
+		data += n;
+		remaining -= n;
+	}
+	_buffer.clear();
+	_pending = 0;
+	if(fsync(_fd) != 0) {
+		BOOST_THROW_EXCEPTION( JournalError() << boost::errinfo_errno(errno) << boost::errinfo_file_name(_filename) );
+	}
+	_lastSync = std::chrono::steady_clock::now();
+}
+
+void FVAJournal::record(ReactionPtr rxn, bool maximize, double value, FVAStatus status) {
+	std::ostringstream ss;
+	ss << std::setprecision(17);
+	// the name comes last, so that it may contain white spaces
+	ss << (maximize ? "max" : "min") << '\t' << status << '\t' << value << '\t' << rxn->getName() << '\n';
+
+	std::lock_guard<std::mutex> guard(_lock);
+	_buffer += ss.str();
+	_pending++;
+	double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - _lastSync).count();
+	if(_pending >= JOURNAL_BATCH_SIZE || elapsed > JOURNAL_SYNC_INTERVAL) {
+		write();
+	}
+}
+
+void FVAJournal::flush() {
+	std::lock_guard<std::mutex> guard(_lock);
+	if(_pending > 0) {
+		write();
+	}
+}
+
+bool FVAJournal::load(std::string filename, ModelPtr model, FVASettingsPtr settings, std::vector<Entry>& entries) {
+	std::ifstream in(filename.c_str());
+	if(!in) {
+		return false;
+	}
+	// the records are only valid for the run that wrote them
+	std::string expected = header(model, settings);
+	std::string found;
+	std::string line;
+	while(found.size() < expected.size() && std::getline(in, line)) {
+		found += line + '\n';
+	}
+	// an empty journal gets its header when it is opened
+	if(!found.empty() && found != expected) {
+		BOOST_THROW_EXCEPTION( JournalError() << boost::errinfo_file_name(filename)
+				<< journal_message("written by a different version, for a different model or with different settings or tolerances") );
+	}
+	while(std::getline(in, line)) {
+		if(in.eof()) break; // the last line was not terminated, so it may be incomplete
+		if(line.empty() || line[0] == '#') continue;
+
+		std::istringstream ss(line);
+		std::string dir, value;
+		int status;
+		Entry e;
+		if(!(ss >> dir >> status >> value) || (dir != "max" && dir != "min")) {
+			BOOST_THROW_EXCEPTION( JournalError() << boost::errinfo_file_name(filename) );
+		}
+		e.maximize = dir == "max";
+		e.status = (FVAStatus) status;
+		e.value = strtod(value.c_str(), NULL); // strtod also handles inf and nan
+		ss.ignore(1); // skip separator
+		std::getline(ss, e.reaction);
+		entries.push_back(e);
+	}
+	return true;
+}
+
+} /* namespace metaopt */
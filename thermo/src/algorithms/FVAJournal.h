@@ -0,0 +1,120 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAJournal.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FVAJOURNAL_H_
+#define FVAJOURNAL_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <boost/shared_ptr.hpp>
+#include <boost/exception/all.hpp>
+
+#include "algorithms/FVA.h"
+#include "model/Model.h"
+#include "model/Reaction.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Append-only journal of the bounds computed by tfva.
+ *
+ * Every finished (reaction, direction) pair is stored as one line, so that an aborted run can be resumed.
+ * Records are buffered and written and synced to disk in batches,
+ * i.e. if the batch is full or the last sync is some time ago.
+ * If the process dies, at most the records of the current batch are lost.
+ *
+ * Reactions are identified by their name.
+ * The header records the model, the settings and the tolerances of the run,
+ * so that the records are never used for a different problem.
+ */
+class FVAJournal : Uncopyable {
+public:
+	struct Entry {
+		std::string reaction;
+		bool maximize;
+		double value;
+		FVAStatus status;
+	};
+
+	/**
+	 * Opens the journal for appending records.
+	 *
+	 * @param filename the journal file
+	 * @param model the model of the run
+	 * @param settings the settings of the run
+	 * @param truncate if true, existing records are deleted, else new records are appended.
+	 * 			Records must only be appended to a journal of the same model and settings (see load).
+	 */
+	FVAJournal(std::string filename, ModelPtr model, FVASettingsPtr settings, bool truncate);
+
+	/**
+	 * writes all pending records and closes the journal.
+	 */
+	virtual ~FVAJournal();
+
+	/**
+	 * Records a computed bound. This method is thread-safe.
+	 */
+	void record(ReactionPtr rxn, bool maximize, double value, FVAStatus status);
+
+	/**
+	 * writes all pending records and syncs the journal to disk. This method is thread-safe.
+	 */
+	void flush();
+
+	/**
+	 * Reads all complete records of a journal.
+	 * Throws JournalError, if the journal was written by a different version,
+	 * for a different model or with different settings or tolerances.
+	 *
+	 * @return false, if the journal file does not exist.
+	 */
+	static bool load(std::string filename, ModelPtr model, FVASettingsPtr settings, std::vector<Entry>& entries);
+
+private:
+	std::string _filename;
+	int _fd; // file descriptor of the journal
+	std::mutex _lock;
+	std::string _buffer; // records not yet written
+	unsigned int _pending; // number of records in _buffer
+	std::chrono::steady_clock::time_point _lastSync;
+
+	void write(); // writes buffer, requires lock
+
+	static std::string header(ModelPtr model, FVASettingsPtr settings); // the header lines of a journal of this run
+};
+
+typedef boost::shared_ptr<FVAJournal> FVAJournalPtr;
+
+/** Thrown if the journal cannot be read or written */
+struct JournalError : virtual boost::exception, virtual std::exception {};
+
+typedef boost::error_info<struct tag_journal_message,std::string> journal_message;
+
+} /* namespace metaopt */
+#endif /* FVAJOURNAL_H_ */
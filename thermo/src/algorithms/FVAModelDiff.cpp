@@ -0,0 +1,151 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAModelDiff.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <deque>
+#include <vector>
+
+#include "FVAModelDiff.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+FVAModelDiff::FVAModelDiff() {
+	// nothing to do
+}
+
+FVAModelDiff::~FVAModelDiff() {
+	// nothing to do
+}
+
+void FVAModelDiff::recordBounds(ReactionPtr r) {
+	// only keep the bounds before the first change
+	if(_bounds.find(r) == _bounds.end()) {
+		_bounds[r] = make_pair(r->getLb(), r->getUb());
+	}
+}
+
+void FVAModelDiff::setLb(ReactionPtr r, double lb) {
+	recordBounds(r);
+	r->setLb(lb);
+}
+
+void FVAModelDiff::setUb(ReactionPtr r, double ub) {
+	recordBounds(r);
+	r->setUb(ub);
+}
+
+void FVAModelDiff::setStoichiometry(ReactionPtr r, MetabolitePtr m, double value) {
+	// if m is removed from r, the former neighbors of r at m are only connected to the change through m
+	_reactions.insert(r);
+	_metabolites.insert(m);
+	r->setStoichiometry(m, value);
+}
+
+void FVAModelDiff::setPotLb(MetabolitePtr m, double lb) {
+	_metabolites.insert(m);
+	m->setPotLb(lb);
+}
+
+void FVAModelDiff::setPotUb(MetabolitePtr m, double ub) {
+	_metabolites.insert(m);
+	m->setPotUb(ub);
+}
+
+void FVAModelDiff::setBoundaryCondition(MetabolitePtr m, bool boundary) {
+	_metabolites.insert(m);
+	m->setBoundaryCondition(boundary);
+}
+
+void FVAModelDiff::markChanged(ReactionPtr r) {
+	_reactions.insert(r);
+}
+
+void FVAModelDiff::markChanged(MetabolitePtr m) {
+	_metabolites.insert(m);
+}
+
+bool FVAModelDiff::empty() const {
+	return _bounds.empty() && _reactions.empty() && _metabolites.empty();
+}
+
+typedef pair<const ReactionPtr, pair<double, double> > BoundsEntry;
+
+void FVAModelDiff::computeAffected(ModelPtr model, const unordered_map<ReactionPtr,double >& min, const unordered_map<ReactionPtr,double >& max,
+		unordered_set<ReactionPtr>& affected) const {
+	/*
+	 * Collect the changes that may remove or add feasible fluxes.
+	 */
+	unordered_set<ReactionPtr> seedReactions(_reactions.begin(), _reactions.end());
+	foreach(const BoundsEntry& e, _bounds) {
+		ReactionPtr r = e.first;
+		if(seedReactions.find(r) != seedReactions.end()) continue;
+		unordered_map<ReactionPtr,double >::const_iterator iter_min = min.find(r);
+		unordered_map<ReactionPtr,double >::const_iterator iter_max = max.find(r);
+		bool relaxed = r->getLb() < e.second.first || r->getUb() > e.second.second;
+		// a tightened bound removes no feasible flux, if the previous range of r lies within the new bounds
+		bool cuts = iter_min == min.end() || iter_max == max.end() || r->getLb() > iter_min->second || r->getUb() < iter_max->second;
+		if(relaxed || cuts) {
+			seedReactions.insert(r);
+		}
+	}
+
+	/*
+	 * Every change may propagate along shared metabolites.
+	 * We also use metabolites with boundary condition, since their potentials still appear in the thermodynamic constraints.
+	 */
+	unordered_map<MetabolitePtr, vector<ReactionPtr> > involved;
+	foreach(ReactionPtr r, model->getReactions()) {
+		foreach(const Stoichiometry& s, r->getStoichiometries()) {
+			involved[s.first].push_back(r);
+		}
+	}
+
+	unordered_set<MetabolitePtr> visited;
+	std::deque<ReactionPtr> queue;
+	foreach(ReactionPtr r, seedReactions) {
+		if(affected.insert(r).second) queue.push_back(r);
+	}
+	foreach(MetabolitePtr m, _metabolites) {
+		if(visited.insert(m).second) {
+			foreach(ReactionPtr r, involved[m]) {
+				if(affected.insert(r).second) queue.push_back(r);
+			}
+		}
+	}
+	while(!queue.empty()) {
+		ReactionPtr r = queue.front();
+		queue.pop_front();
+		foreach(const Stoichiometry& s, r->getStoichiometries()) {
+			if(visited.insert(s.first).second) {
+				foreach(ReactionPtr other, involved[s.first]) {
+					if(affected.insert(other).second) queue.push_back(other);
+				}
+			}
+		}
+	}
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,104 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAModelDiff.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FVAMODELDIFF_H_
+#define FVAMODELDIFF_H_
+
+#include <utility>
+#include <boost/unordered_set.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "model/Model.h"
+#include "model/Reaction.h"
+#include "model/Metabolite.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Records edits of a model after an FVA run, so that only the results that may have changed need to be recomputed (see tfva).
+ *
+ * Perform the edits through the methods of this class, which apply them to the model and remember what was changed.
+ * For other edits, use markChanged.
+ */
+class FVAModelDiff {
+public:
+	FVAModelDiff();
+	virtual ~FVAModelDiff();
+
+	/** sets the flux lower bound of r and records the change */
+	void setLb(ReactionPtr r, double lb);
+
+	/** sets the flux upper bound of r and records the change */
+	void setUb(ReactionPtr r, double ub);
+
+	/** sets the stoichiometric coefficient of m in r and records the change */
+	void setStoichiometry(ReactionPtr r, MetabolitePtr m, double value);
+
+	/** sets the potential lower bound of m and records the change */
+	void setPotLb(MetabolitePtr m, double lb);
+
+	/** sets the potential upper bound of m and records the change */
+	void setPotUb(MetabolitePtr m, double ub);
+
+	/** sets the boundary condition of m and records the change */
+	void setBoundaryCondition(MetabolitePtr m, bool boundary);
+
+	/** records an arbitrary change of r */
+	void markChanged(ReactionPtr r);
+
+	/** records an arbitrary change of m */
+	void markChanged(MetabolitePtr m);
+
+	/**
+	 * Computes the reactions whose FVA results may differ from the previous results min and max.
+	 *
+	 * Any change may influence every reaction that is connected to it by a chain of shared metabolites
+	 * (through steady state or through the potentials of the thermodynamic constraints),
+	 * so all reactions of the connected components of the changes are affected.
+	 * The only exception are tightened flux bounds that do not cut into the previous range of the reaction,
+	 * since they do not remove any feasible flux.
+	 *
+	 * The propagation is deliberately not limited (e.g. by skipping currency metabolites or metabolites with boundary condition,
+	 * or by following the flux coupling only), since each of these limits may miss reactions whose results changed.
+	 * Hence, in a connected genome-scale model, an edit usually affects nearly all reactions,
+	 * and only edits in small separate components or tightened bounds that do not cut save computations.
+	 * The optimality constraint of tfva is not considered here (see tfva).
+	 */
+	void computeAffected(ModelPtr model, const boost::unordered_map<ReactionPtr,double >& min, const boost::unordered_map<ReactionPtr,double >& max,
+			boost::unordered_set<ReactionPtr>& affected) const;
+
+	/** returns true, if no change was recorded */
+	bool empty() const;
+
+private:
+	boost::unordered_map<ReactionPtr, std::pair<double, double> > _bounds; // original bounds of reactions whose only change are bounds
+	boost::unordered_set<ReactionPtr> _reactions; // otherwise changed reactions
+	boost::unordered_set<MetabolitePtr> _metabolites; // changed metabolites
+
+	void recordBounds(ReactionPtr r);
+};
+
+} /* namespace metaopt */
+#endif /* FVAMODELDIFF_H_ */
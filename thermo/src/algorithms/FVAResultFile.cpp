@@ -0,0 +1,241 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAResultFile.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <stdio.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+
+#include "FVAResultFile.h"
+#include "model/ModelHash.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+#define RESULT_HEADER "# metaopt fva result"
+
+typedef pair<const ReactionPtr, double> BoundEntry;
+
+void FVAResultFile::write(std::string filename, ModelPtr model, std::string settings, unsigned int shard, unsigned int num_shards,
+		const unordered_map<ReactionPtr,double >& min, const unordered_map<ReactionPtr,double >& max) {
+	vector<Entry> entries;
+	foreach(const BoundEntry& e, min) {
+		unordered_map<ReactionPtr,double >::const_iterator iter = max.find(e.first);
+		if(iter != max.end()) {
+			Entry entry;
+			entry.reaction = e.first->getName();
+			entry.min = e.second;
+			entry.max = iter->second;
+			entries.push_back(entry);
+		}
+	}
+
+	// several processes may write the same file, so every process uses its own temporary file
+	ostringstream tmpname;
+	tmpname << filename << "." << getpid() << ".tmp";
+	string tmp = tmpname.str();
+	{
+		ofstream out(tmp.c_str());
+		out << setprecision(17);
+		out << RESULT_HEADER << endl;
+		out << "version " << VERSION << endl;
+		out << "model " << hashModel(model) << endl;
+		out << "flux_tol " << model->getFluxPrecision()->getCheckTol() << endl;
+		out << "pot_tol " << model->getPotPrecision()->getCheckTol() << endl;
+		out << "settings " << settings << endl;
+		out << "shard " << shard << " " << num_shards << endl;
+		out << "reactions " << entries.size() << endl;
+		foreach(const Entry& e, entries) {
+			// the name comes last, so that it may contain white spaces
+			out << e.min << '\t' << e.max << '\t' << e.reaction << '\n';
+		}
+		out << "end" << endl;
+		out.close();
+		if(!out) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(tmp) );
+		}
+	}
+	if(rename(tmp.c_str(), filename.c_str()) != 0) {
+		BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_errno(errno) << boost::errinfo_file_name(filename) );
+	}
+}
+
+/**
+ * reads the line "<key> <value>" from in into value
+ */
+template<typename T>
+static void readField(istream& in, const string& filename, const char* key, T& value) {
+	string line, name;
+	getline(in, line);
+	istringstream ss(line);
+	if(!(ss >> name) || name != key || !(ss >> value)) {
+		BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message(string("expected field ") + key) );
+	}
+}
+
+/**
+ * reads a double, also handles inf and nan
+ */
+static double parseDouble(const string& value) {
+	return strtod(value.c_str(), NULL);
+}
+
+void FVAResultFile::read(std::string filename, Header& header, std::vector<Entry>& entries) {
+	ifstream in(filename.c_str());
+	if(!in) {
+		BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("cannot open file") );
+	}
+	string line;
+	getline(in, line);
+	if(line != RESULT_HEADER) {
+		BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("not a result file") );
+	}
+	string flux_tol, pot_tol;
+	readField(in, filename, "version", header.version);
+	readField(in, filename, "model", header.model);
+	readField(in, filename, "flux_tol", flux_tol);
+	readField(in, filename, "pot_tol", pot_tol);
+	header.flux_tol = parseDouble(flux_tol);
+	header.pot_tol = parseDouble(pot_tol);
+	readField(in, filename, "settings", header.settings);
+	{
+		getline(in, line);
+		istringstream ss(line);
+		string name;
+		if(!(ss >> name >> header.shard >> header.num_shards) || name != "shard") {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("expected field shard") );
+		}
+	}
+	readField(in, filename, "reactions", header.num_reactions);
+
+	for(unsigned int i = 0; i < header.num_reactions; i++) {
+		getline(in, line);
+		istringstream ss(line);
+		string min, max;
+		Entry e;
+		if(!(ss >> min >> max)) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("file is truncated") );
+		}
+		e.min = parseDouble(min);
+		e.max = parseDouble(max);
+		ss.ignore(1); // skip separator
+		getline(ss, e.reaction);
+		entries.push_back(e);
+	}
+	if(!getline(in, line) || line != "end") {
+		BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("file is truncated") );
+	}
+}
+
+void FVAResultFile::merge(ModelPtr model, std::string settings, const std::vector<std::string>& filenames,
+		unordered_map<ReactionPtr,double >& min, unordered_map<ReactionPtr,double >& max) {
+	if(filenames.empty()) {
+		BOOST_THROW_EXCEPTION( ResultFileError() << result_file_message("no result files given") );
+	}
+
+	// reactions are identified by name, so names must be unique
+	unordered_map<string, ReactionPtr> reactions;
+	foreach(ReactionPtr r, model->getReactions()) {
+		if(!reactions.insert(make_pair(r->getName(), r)).second) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << reaction_name(r->getName()) << result_file_message("reaction names are not unique") );
+		}
+	}
+
+	string hash = hashModel(model);
+	double flux_tol = model->getFluxPrecision()->getCheckTol();
+	double pot_tol = model->getPotPrecision()->getCheckTol();
+
+	string version;
+	vector<char> shards;
+	unordered_map<ReactionPtr,double > merged_min, merged_max;
+	foreach(const string& filename, filenames) {
+		Header header;
+		vector<Entry> entries;
+		read(filename, header, entries);
+
+		if(header.model != hash) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("computed on a different model") );
+		}
+		// the values were written with 17 digits, so they are read back exactly
+		if(header.flux_tol != flux_tol || header.pot_tol != pot_tol) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("computed with different tolerances") );
+		}
+		if(version.empty()) {
+			version = header.version;
+			shards.resize(header.num_shards, false);
+		}
+		if(header.version != version) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("computed by a different version") );
+		}
+		if(header.settings != settings) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("computed with different settings (e.g. a different optimality fraction or objective)") );
+		}
+		if(header.num_shards != shards.size() || header.shard >= shards.size()) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("belongs to a run with a different number of shards") );
+		}
+		if(shards[header.shard]) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << result_file_message("shard is given twice") );
+		}
+		shards[header.shard] = true;
+
+		foreach(const Entry& e, entries) {
+			unordered_map<string, ReactionPtr>::iterator iter = reactions.find(e.reaction);
+			if(iter == reactions.end()) {
+				BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << reaction_name(e.reaction) << result_file_message("unknown reaction") );
+			}
+			if(merged_min.find(iter->second) != merged_min.end()) {
+				BOOST_THROW_EXCEPTION( ResultFileError() << boost::errinfo_file_name(filename) << reaction_name(e.reaction) << result_file_message("reaction is contained in several shards") );
+			}
+			merged_min[iter->second] = e.min;
+			merged_max[iter->second] = e.max;
+		}
+	}
+
+	for(unsigned int i = 0; i < shards.size(); i++) {
+		if(!shards[i]) {
+			ostringstream ss;
+			ss << "shard " << i << " of " << shards.size() << " is missing";
+			BOOST_THROW_EXCEPTION( ResultFileError() << result_file_message(ss.str()) );
+		}
+	}
+	foreach(ReactionPtr r, model->getReactions()) {
+		if(merged_min.find(r) == merged_min.end()) {
+			BOOST_THROW_EXCEPTION( ResultFileError() << reaction_name(r->getName()) << result_file_message("reaction is missing in all shards") );
+		}
+	}
+
+	foreach(const BoundEntry& e, merged_min) {
+		min[e.first] = e.second;
+	}
+	foreach(const BoundEntry& e, merged_max) {
+		max[e.first] = e.second;
+	}
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,98 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FVAResultFile.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FVARESULTFILE_H_
+#define FVARESULTFILE_H_
+
+#include <string>
+#include <vector>
+#include <boost/unordered_map.hpp>
+#include <boost/exception/all.hpp>
+
+#include "model/Model.h"
+#include "model/Reaction.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Self-describing file with the FVA results of one shard of a sharded run.
+ *
+ * A large FVA can be split into num_shards independent runs (possibly on different machines),
+ * where each run only computes the reactions of its shard and writes them to a result file.
+ * Besides the bounds, the file records the program version, the hash of the model (see hashModel), the tolerances
+ * and the settings that influence the results (see describeResultSettings), so that merge can check that all shards were computed on the same problem.
+ *
+ * Reactions are identified by their name.
+ */
+class FVAResultFile {
+public:
+	struct Header {
+		std::string version;
+		std::string model; // see hashModel
+		std::string settings; // settings that influence the results, see describeResultSettings
+		double flux_tol; // check tolerance of the flux precision
+		double pot_tol; // check tolerance of the potential precision
+		unsigned int shard;
+		unsigned int num_shards;
+		unsigned int num_reactions;
+	};
+
+	struct Entry {
+		std::string reaction;
+		double min;
+		double max;
+	};
+
+	/**
+	 * Writes the results of the given shard.
+	 * The file is written under a temporary name and renamed afterwards, so it is either complete or does not exist.
+	 * Only reactions that have a result for min and max are written.
+	 * settings must not contain white spaces.
+	 */
+	static void write(std::string filename, ModelPtr model, std::string settings, unsigned int shard, unsigned int num_shards,
+			const boost::unordered_map<ReactionPtr,double >& min, const boost::unordered_map<ReactionPtr,double >& max);
+
+	/**
+	 * Reads a result file.
+	 */
+	static void read(std::string filename, Header& header, std::vector<Entry>& entries);
+
+	/**
+	 * Reads the result files of all shards of a run and stores the bounds in min and max.
+	 * Throws ResultFileError, if the files were not computed on this model with the tolerances of this model,
+	 * if they were not computed with the given settings (see describeResultSettings), if a shard is missing or duplicate,
+	 * or if not every reaction of the model got exactly one result.
+	 */
+	static void merge(ModelPtr model, std::string settings, const std::vector<std::string>& filenames,
+			boost::unordered_map<ReactionPtr,double >& min, boost::unordered_map<ReactionPtr,double >& max);
+};
+
+/** Thrown if a result file cannot be read or written, or if result files do not fit together */
+struct ResultFileError : virtual boost::exception, virtual std::exception {};
+
+typedef boost::error_info<struct tag_result_file_message,std::string> result_file_message;
+
+} /* namespace metaopt */
+#endif /* FVARESULTFILE_H_ */
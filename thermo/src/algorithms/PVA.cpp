@@ -0,0 +1,227 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * PVA.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <math.h>
+#include <algorithm>
+#include "scip/scip.h"
+
+#include "PVA.h"
+#include "TFVAWorker.h"
+#include "model/impl/FullModel.h"
+#include "model/scip/LPFlux.h"
+#include "model/scip/LPPotentials.h"
+#include "model/scip/Solution.h"
+#include "scip/ScipError.h"
+#include "scip/event/InterruptEventHandler.h"
+#include "Properties.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+/**
+ * changes the bounds of rxn in flux, the order of changes makes sure that lb <= ub holds at any time
+ */
+static void setFluxBounds(LPFluxPtr flux, ReactionPtr rxn, double lb, double ub) {
+	if(lb > flux->getUb(rxn)) {
+		flux->setUb(rxn, ub);
+		flux->setLb(rxn, lb);
+	}
+	else {
+		flux->setLb(rxn, lb);
+		flux->setUb(rxn, ub);
+	}
+}
+
+/**
+ * checks if the potentials of the current solution of screen are attainable.
+ *
+ * check searches a steady-state flux that runs no reaction along its potential difference.
+ * Reactions without potential difference are blocked at first and only released, if no such flux exists.
+ * If the directions of the flux admit strictly feasible potentials, the potentials of screen lie in the closure of these.
+ */
+static bool isPotentialAttainable(ModelPtr model, LPPotentialsPtr screen, LPFluxPtr check, LPPotentialsPtr potTest) {
+	const PrecisionPtr& potPrec = model->getPotPrecision();
+
+	unordered_map<ReactionPtr, double> diff;
+	bool undirected = false;
+	foreach(ReactionPtr r, model->getReactions()) {
+		if(!r->isExchange()) {
+			double d = 0;
+			foreach(Stoichiometry s, r->getStoichiometries()) {
+				d += s.second * screen->getPotential(s.first);
+			}
+			diff[r] = d;
+			if(fabs(d) <= potPrec->getCheckTol()) undirected = true;
+		}
+	}
+
+	for(int pass = 0; pass < (undirected ? 2 : 1); pass++) {
+		bool block = undirected && pass == 0;
+		bool possible = true;
+		foreach(ReactionPtr r, model->getReactions()) {
+			double lb = r->getLb();
+			double ub = r->getUb();
+			if(!r->isExchange()) {
+				double d = diff.at(r);
+				if(d < potPrec->getCheckTol()) {
+					lb = std::max(lb, 0.0); // no backward flux
+				}
+				if(d > -potPrec->getCheckTol()) {
+					ub = std::min(ub, 0.0); // no forward flux
+				}
+				if(!block && fabs(d) <= potPrec->getCheckTol()) {
+					// released
+					lb = r->getLb();
+					ub = r->getUb();
+				}
+			}
+			if(lb > ub) {
+				possible = false;
+				break;
+			}
+			setFluxBounds(check, r, lb, ub);
+		}
+		if(possible) {
+			check->solveDual();
+			if(check->isOptimal()) {
+				bool result;
+				potTest->setDirections(check);
+				return potTest->testStrictFeasible(result) && result;
+			}
+		}
+	}
+	return false;
+}
+
+/**
+ * solves the CIP with the potential of met as objective and tests its solutions like the LP screening.
+ * lpBound is the optimum of the screening LP, which also bounds the CIP from outside.
+ */
+static FVABound solvePotentialCIP(ModelPtr model, MetabolitePtr met, bool maximize, double lpBound, LPPotentialsPtr potTest, FVASettingsPtr settings) {
+	FVADirectionsModelFactory factory;
+	met->setPotObj(1);
+	ScipModelPtr scip = factory.build(model);
+	scip->getPotential(met); // the metabolite may only occur in exchange reactions
+	met->setPotObj(0);
+	scip->setObjectiveSense(maximize);
+	if(settings->cip_timeout > 1) { // a timeout of less than a second makes no sense
+		BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", settings->cip_timeout) );
+	}
+	if(settings->cancellation) {
+		createInterruptEventHandler(scip, settings->cancellation);
+	}
+	scip->solve();
+	checkCancelled(settings->cancellation);
+
+	FVABound bound;
+	double dual = scip->getDualBound();
+	bound.outer = maximize ? std::min(lpBound, dual) : std::max(lpBound, dual);
+	bound.inner = maximize ? -INFINITY : INFINITY;
+
+	/*
+	 * The direction variables are only linked to the potentials by a relaxation,
+	 * so a solution is only thermodynamically feasible, if it passes the strict test.
+	 * The solutions are sorted by objective value, so the first one passing the test is the best one.
+	 */
+	SCIP_SOL** sols = SCIPgetSols(scip->getScip());
+	int nsols = SCIPgetNSols(scip->getScip());
+	for(int i = 0; i < nsols; i++) {
+		bool feasible;
+		potTest->setDirections(wrap_weak(sols[i]), scip);
+		if(potTest->testStrictFeasible(feasible) && feasible) {
+			bound.inner = SCIPgetSolOrigObj(scip->getScip(), sols[i]);
+			if(i == 0 && SCIPgetStatus(scip->getScip()) == SCIP_STATUS_OPTIMAL) {
+				return FVABound(bound.inner, FVA_CIP);
+			}
+			break;
+		}
+	}
+	return bound;
+}
+
+/**
+ * computes the minimal or maximal potential of met.
+ */
+static FVABound computeBound(ModelPtr model, MetabolitePtr met, bool maximize, LPPotentialsPtr screen, LPFluxPtr check, LPPotentialsPtr potTest, FVASettingsPtr settings) {
+	checkCancelled(settings->cancellation);
+
+	double lpBound = maximize ? INFINITY : -INFINITY;
+	screen->setObj(met, maximize ? 1 : -1);
+	bool solved = screen->optimize();
+	screen->setObj(met, 0);
+	if(solved) {
+		lpBound = screen->getPotential(met);
+		if(isPotentialAttainable(model, screen, check, potTest)) {
+			return FVABound(lpBound, FVA_LP);
+		}
+	}
+	// the LP is unbounded or its optimum is not attainable
+	return solvePotentialCIP(model, met, maximize, lpBound, potTest, settings);
+}
+
+void pva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<MetabolitePtr,FVABound >& min , boost::unordered_map<MetabolitePtr,FVABound >& max ) {
+	// objectives are changed during the computation, so we work on a copy
+	unordered_map<ReactionPtr, ReactionPtr> rxns;
+	unordered_map<MetabolitePtr, MetabolitePtr> mets;
+	ModelPtr copy = copyModel(model, rxns, mets);
+	foreach(ReactionPtr r, copy->getReactions()) {
+		r->setObj(0);
+	}
+	foreach(MetabolitePtr m, copy->getMetabolites()) {
+		m->setPotObj(0);
+	}
+
+	LPFluxPtr check(new LPFlux(copy, true));
+	check->solve();
+	if(!check->isOptimal()) {
+		BOOST_THROW_EXCEPTION( InfeasibleModelError() );
+	}
+
+	// reactions that carry flux in every steady state fix the sign of their potential difference
+	unordered_map<ReactionPtr, double> fmin, fmax;
+	fva(copy, fmin, fmax, settings->threads > 1 ? settings->threads : 1, settings->cancellation);
+
+	LPPotentialsPtr screen(new LPPotentials(copy));
+	LPPotentialsPtr potTest(new LPPotentials(copy));
+	const PrecisionPtr& fluxPrec = copy->getFluxPrecision();
+	foreach(ReactionPtr r, copy->getReactions()) {
+		if(!r->isExchange()) {
+			if(fmin.at(r) > fluxPrec->getCheckTol()) {
+				screen->setDirection(r, true);
+			}
+			else if(fmax.at(r) < -fluxPrec->getCheckTol()) {
+				screen->setDirection(r, false);
+			}
+		}
+	}
+
+	foreach(MetabolitePtr m, model->getMetabolites()) {
+		MetabolitePtr met = mets.at(m);
+		max[m] = computeBound(copy, met, true, screen, check, potTest, settings);
+		min[m] = computeBound(copy, met, false, screen, check, potTest, settings);
+	}
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,61 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+/*
+ * PVA.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef PVA_H_
+#define PVA_H_
+
+#include <boost/unordered_map.hpp>
+#include "model/Model.h"
+#include "model/Metabolite.h"
+#include "FVA.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Runs potential variability analysis on the given model,
+ * i.e. computes the minimal and maximal potential of every metabolite over all thermodynamically feasible steady states.
+ *
+ * Every bound is first screened by an LP over the potentials (see LPPotentials), which is warm started from the previous bound.
+ * The LP only restricts the potential differences of the reactions that carry flux in every steady state (computed by fva),
+ * so its optimum bounds the thermodynamically feasible optimum from outside.
+ * The optimum is attained, if some steady-state flux runs every reaction against its potential difference in the LP solution
+ * and the directions of this flux admit strictly feasible potentials.
+ * Only if this test fails, a CIP with the potential as objective is solved (see FVADirectionsModelFactory),
+ * and its solutions are tested in the same way.
+ *
+ * As for fluxes in tfva, the bounds are suprema and infima, since the thermodynamic constraints are strict inequalities.
+ * min and max receive a bound for every metabolite of the model. Its status is FVA_LP, if the LP screening sufficed, and FVA_CIP, if the CIP was needed.
+ * If the CIP was stopped by settings->cip_timeout or none of its solutions passes the test, only an interval is known (FVA_BOUNDED).
+ * Note that potentials without finite bounds are usually unbounded.
+ *
+ * Of the settings, only threads (for the fva of the screening), cip_timeout and cancellation are used.
+ * If the model has no steady state, an InfeasibleModelError is thrown.
+ */
+void pva(ModelPtr model, FVASettingsPtr settings, boost::unordered_map<MetabolitePtr,FVABound >& min , boost::unordered_map<MetabolitePtr,FVABound >& max );
+
+/** Thrown by pva if the model has no steady-state flux */
+struct InfeasibleModelError : virtual boost::exception, virtual std::exception {};
+
+} /* namespace metaopt */
+#endif /* PVA_H_ */
@@ -0,0 +1,708 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * TFVAWorker.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+#include <thread>
+#include <exception>
+#include "scip/scip.h"
+
+#include "TFVAWorker.h"
+#include "Properties.h"
+#include "model/impl/FullModel.h"
+#include "scip/ScipError.h"
+#include "scip/constraints/SteadyStateConstraint.h"
+#include "scip/constraints/ThermoConstraintHandler.h"
+#include "scip/constraints/RelaxedNaiveThermoConstraint.h"
+#include "model/scip/addon/PotentialDifferences.h"
+#include "model/scip/addon/ReactionDirections.h"
+#include "scip/heur/CycleDeletionHeur.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+// number of witnesses that are passed to a CIP as start solutions
+#define NUM_START_SOLUTIONS 3
+// number of solutions of a CIP that are added to the witness pool
+#define NUM_HARVESTED_SOLUTIONS 3
+
+/**
+ * adds the extra flux constraints as linear constraints to scip
+ */
+static void addFluxConstraints(ScipModelPtr scip, const vector<FluxConstraintPtr>& constraints) {
+	foreach(FluxConstraintPtr c, constraints) {
+		vector<SCIP_VAR*> vars;
+		vector<double> coefs;
+		typedef pair<const ReactionPtr, double> Coef;
+		foreach(const Coef& e, c->coef) {
+			vars.push_back(scip->getFlux(e.first));
+			coefs.push_back(e.second);
+		}
+		SCIP_CONS* cons = NULL;
+		BOOST_SCIP_CALL( SCIPcreateConsLinear(scip->getScip(), &cons, "flux constraint", vars.size(), vars.data(), coefs.data(), c->lhs, c->rhs,
+				TRUE, TRUE, TRUE, TRUE, TRUE, FALSE, FALSE, FALSE, FALSE, FALSE) );
+		BOOST_SCIP_CALL( SCIPaddCons(scip->getScip(), cons) );
+		BOOST_SCIP_CALL( SCIPreleaseCons(scip->getScip(), &cons) );
+	}
+}
+
+ScipModelPtr FVAThermoModelFactory::build(ModelPtr m) {
+	ScipModelPtr scip(new ScipModel(m));
+	createSteadyStateConstraint(scip);
+	addFluxConstraints(scip, fluxConstraints);
+	if(feasibilityCache.use_count() >= 1 || infeasibleSetPool.use_count() >= 1) {
+		createThermoConstraint(scip, coupling, feasibilityCache, infeasibleSetPool);
+		createCycleDeletionHeur(scip, feasibilityCache);
+	}
+	else {
+		if(coupling.use_count() >= 1) {
+			createThermoConstraint(scip, coupling);
+		}
+		else {
+			createThermoConstraint(scip);
+		}
+		createCycleDeletionHeur(scip);
+	}
+	//registerExitEventHandler(scip);
+
+	return scip;
+}
+
+ScipModelPtr FVADirectionsModelFactory::build(ModelPtr m) {
+	ScipModelPtr scip(new ScipModel(m));
+	createSteadyStateConstraint(scip);
+	addFluxConstraints(scip, fluxConstraints);
+	PotentialDifferencesPtr potDiff = createPotentialDifferences(scip);
+	scip->addAddOn(potDiff);
+	ReactionDirectionsPtr dirs = createReactionDirections(scip, potDiff);
+	scip->addAddOn(dirs);
+	createRelaxedNaiveThermoConstraint(scip, dirs);
+
+	return scip;
+}
+
+/**
+ * checks if a loopless free flux with the same objective value can be attained
+ */
+bool isLooplessFluxAttainable(LPFluxPtr sol, LPFluxPtr helper) {
+	ModelPtr model = sol->getModel();
+	const PrecisionPtr& solPrec = sol->getPrecision();
+	helper->setDirectionBounds(sol);
+	helper->setZeroObj();
+	foreach(ReactionPtr r, model->getObjectiveReactions()) {
+		if(!r->isExchange()) {
+			double val = sol->getFlux(r);
+			if(val > solPrec->getCheckTol()) {
+				helper->setObj(r, 1);
+			}
+			else if(val < -solPrec->getCheckTol()) {
+				helper->setObj(r, -1);
+			}
+		}
+	}
+	foreach(ReactionPtr r, model->getFluxForcingReactions()) {
+		if(!r->isExchange()) {
+			double val = sol->getFlux(r);
+			if(val > solPrec->getCheckTol()) {
+				helper->setObj(r, 1);
+			}
+			else if(val < -solPrec->getCheckTol()) {
+				helper->setObj(r, -1);
+			}
+		}
+	}
+	foreach(ReactionPtr r, model->getProblematicReactions()) {
+		if(!r->isExchange()) {
+			double val = sol->getFlux(r);
+			if(val > solPrec->getCheckTol()) {
+				helper->setObj(r, 1);
+			}
+			else if(val < -solPrec->getCheckTol()) {
+				helper->setObj(r, -1);
+			}
+		}
+	}
+	helper->solve();
+	if(!helper->isOptimal()) { // if we weren't able to compute the optimum, we better be pessimistic
+		return false;
+	}
+#ifndef SILENT
+	std::cout << "test: " << helper->getObjVal() << std::endl;
+#endif
+	return helper->getObjVal() < helper->getPrecision()->getCheckTol();
+}
+
+/**
+ * checks if a thermodynamically feasible flux with the same objective value can be attained
+ */
+bool isThermoFluxAttainable(LPFluxPtr sol, LPFluxPtr helper, LPPotentialsPtr potTest, CancellationTokenPtr token) {
+	// make sure that subtracting cycles does not violate flux bounds or objective value
+	assert(isLooplessFluxAttainable(sol, helper));
+	ModelPtr model = sol->getModel();
+	const PrecisionPtr& solPrec = sol->getPrecision();
+	const PrecisionPtr& helperPrec = helper->getPrecision();
+#ifndef NDEBUG
+	int debugi = 0;
+#endif
+	do {
+		checkCancelled(token);
+		helper->setDirectionBounds(sol);
+		helper->setZeroObj();
+		foreach(ReactionPtr r, model->getInternalReactions()) {
+			double val = sol->getFlux(r);
+			if(val > solPrec->getCheckTol()) {
+				helper->setObj(r, 1);
+			}
+			else if(val < -solPrec->getCheckTol()) {
+				helper->setObj(r, -1);
+			}
+		}
+		helper->solve();
+		if(!helper->isFeasible()) { // something strange, abort
+			return false;
+		}
+		if(helper->getObjVal() > helperPrec->getCheckTol()) {
+			double scale = sol->getSubScale(helper);
+			if(scale < -0.5) return false;
+			sol->subtract(helper, scale);
+		}
+#ifndef NDEBUG
+		debugi++;
+		if(debugi % 1000 == 0) std::cout << "FVA.cpp " << __LINE__ << " caught endless loop" << std::endl;
+#endif
+	} while(helper->getObjVal() > helperPrec->getCheckTol());
+	// now we computed a guess of a thermodynamically feasible flow, now we have to check
+	potTest->setDirections(sol);
+	bool result;
+	if(!potTest->testStrictFeasible(result)) {
+		return false;
+	}
+	else return result;
+}
+
+TFVAWorker::TFVAWorker(ModelPtr model, const vector<ReactionPtr>& reactions, FVASettingsPtr settings, WitnessPoolPtr pool, ThermoFeasibilityCachePtr cache, SharedInfeasibleSetPoolPtr infeasibleSets, SharedCouplingPtr coupling) : _settings(settings), _boundReached(NULL), _interrupt(NULL), _pool(pool), _sharedCoupling(coupling), _sharedPosition(0) {
+	unordered_map<ReactionPtr, ReactionPtr> rxns;
+	unordered_map<MetabolitePtr, MetabolitePtr> mets;
+	_model = copyModel(model, rxns, mets);
+	_toCopy = rxns;
+
+	_reactions.reserve(reactions.size());
+	foreach(ReactionPtr r, reactions) {
+		_reactions.push_back(rxns.at(r));
+	}
+
+	if(_pool) {
+		unordered_map<ReactionPtr, unsigned int> index;
+		foreach(ReactionPtr r, _pool->getReactions()) {
+			index[rxns.at(r)] = _poolReactions.size();
+			_poolReactions.push_back(rxns.at(r));
+		}
+		foreach(ReactionPtr r, _reactions) {
+			_poolIndex.push_back(index.at(r));
+		}
+	}
+
+	/*
+	 * Depending on the kind of thermodynamic information given there are different kinds of speedups possible.
+	 * If no potential bounds are given, we just have loopless FVA and we can check if FBA = tFBA by solving two LPs
+	 * In the other case, we basically have to run the cycle elimination heur
+	 */
+	_simple = true;
+	foreach(MetabolitePtr met, _model->getMetabolites()) {
+		if(isinf(met->getPotLb()) == 0) {
+			_simple = false;
+		}
+		if(isinf(met->getPotUb()) == 0) {
+			_simple = false;
+		}
+	}
+
+	// increase dual model flux precision, since we use computation results to add constraints
+	_model->setFluxPrecision(model->getFluxPrecision()->getDualSlavePrecision());
+
+	// the coupling is modified by the constraint handler, so every worker needs its own copy
+	if(settings->coupling.use_count() >= 1) {
+		_factory.coupling = settings->coupling->copy(rxns);
+	}
+	if(_sharedCoupling) {
+		typedef pair<ReactionPtr, ReactionPtr> RxnPair;
+		foreach(const RxnPair& p, rxns) {
+			_toOriginal[p.second] = p.first;
+		}
+		if(_factory.coupling.use_count() == 0) {
+			_factory.coupling.reset(new Coupling()); // the constraint handlers record what they learn in the coupling they are given
+		}
+	}
+	_factory.feasibilityCache = cache;
+	_factory.infeasibleSetPool = infeasibleSets;
+
+	/**
+	 * reset objective functions
+	 */
+	foreach(ReactionPtr a, _model->getReactions()) {
+		a->setObj(0);
+	}
+	foreach(MetabolitePtr a, _model->getMetabolites()) {
+		a->setPotObj(0);
+	}
+
+	/*
+	 * for the cases where it is sufficient to run an LP, we just run an LP
+	 *
+	 * We will maximize fluxes and minimizes fluxes in parallel.
+	 * This way we can exploit that we do not need to solve CPs for reactions which are already fixed by LP
+	 * We use two different LPs for it, so that we don't have to change the objective too much.
+	 */
+	_max_flux.reset(new LPFlux(_model, true));
+	_min_flux.reset(new LPFlux(_model, true));
+
+	// the helper flux is used to test if the LP solution is already optimal
+	_helper.reset(new LPFlux(_model, false));
+	_helper->setObjSense(true);
+
+	// helper needs more precision, since it is called iteratively to remove loops
+	_helper->setPrecision(_model->getFluxPrecision()->getPrimalSlavePrecision());
+
+	if(!_simple) {
+		_potTest.reset(new LPPotentials(_model));
+		if(cache.use_count() >= 1) {
+			_potTest->setFeasibilityCache(cache);
+		}
+	}
+
+	_max_flux->setObjSense(true);
+	_min_flux->setObjSense(false);
+}
+
+TFVAWorker::~TFVAWorker() {
+	// nothing to do
+}
+
+FVABound TFVAWorker::solveCIP(unsigned int i, bool maximize, double timelimit, double bound) {
+	ReactionPtr a = _reactions.at(i);
+	// the flux bounds of a are also bounds on the objective
+	bound = maximize ? std::min(bound, a->getUb()) : std::max(bound, a->getLb());
+	a->setObj(1);
+
+	if(_sharedCoupling) {
+		// start from the couplings learned by all CIPs so far
+		_sharedPosition = _sharedCoupling->update(*_factory.coupling, _toCopy, _sharedPosition);
+	}
+
+	ScipModelPtr scip = buildCIP();
+	if(timelimit > 1) { // a timeout of less than a second makes no sense
+		BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", timelimit) );
+	}
+	else if(_settings->persistent) {
+		BOOST_SCIP_CALL( SCIPresetParam(scip->getScip(), "limits/time") ); // remove the limit of the last solve
+	}
+	scip->setObjectiveSense(maximize);
+
+	/*
+	 * The bound is already a valid dual bound, so as soon as a solution attains it, we are done.
+	 * We cannot use it as objective limit, since SCIP would then only accept solutions that are strictly better.
+	 */
+	_boundReached->setBound(bound);
+	double opt;
+	if(_pool && injectWitnesses(scip, i, maximize) && _boundReached->isReached(scip->getPrimalBound())) {
+		// a start solution is already optimal
+		opt = scip->getPrimalBound();
+		a->setObj(0);
+		return FVABound(opt, FVA_CIP);
+	}
+
+	bool lost = race(scip, maximize, timelimit, opt);
+	checkCancelled(_settings->cancellation); // the CIP may have been interrupted by the cancellation
+	if(_pool) {
+		harvestWitnesses(scip);
+	}
+	if(_sharedCoupling) {
+		_sharedCoupling->merge(*_factory.coupling, _toOriginal);
+	}
+	if(lost) {
+		// the alternative formulation was faster, scip was interrupted
+		a->setObj(0);
+		return FVABound(opt, FVA_CIP);
+	}
+
+	SCIP_STATUS status = SCIPgetStatus(scip->getScip());
+	if(status == SCIP_STATUS_USERINTERRUPT && _boundReached->isReached(scip->getPrimalBound())) {
+		// interrupted by _boundReached, the incumbent is optimal
+		opt = scip->getPrimalBound();
+		a->setObj(0);
+		return FVABound(opt, FVA_CIP);
+	}
+	if(status == SCIP_STATUS_TIMELIMIT || status == SCIP_STATUS_USERINTERRUPT) {
+		// report what we know so far
+		FVABound bound;
+		bound.outer = scip->getDualBound();
+		bound.inner = scip->getPrimalBound();
+		bound.status = FVA_BOUNDED;
+
+		a->setObj(0);
+		return bound;
+	}
+
+#ifndef NDEBUG
+	if(!scip->isOptimal()) {
+		LPFluxPtr flux = maximize ? _max_flux : _min_flux;
+		PrecisionPtr prec = _model->getFluxPrecision();
+		SCIPprintStatistics(scip->getScip(), NULL);
+		cout << "LP primal infeasible = " << SCIPlpiIsPrimalInfeasible(flux->getLPI()) << endl;
+		if( SCIPlpiHasDualRay(flux->getLPI())) {
+			double dualfarkas[_model->getMetabolites().size()];
+			SCIPlpiGetDualfarkas(flux->getLPI(), dualfarkas);
+			foreach(MetabolitePtr met, _model->getMetabolites()) {
+				double d = dualfarkas[flux->getIndex(met)];
+				if(d < -prec->getDualFeasTol() || d > prec->getDualFeasTol()) {
+					cout << met->getName() << " = " << d << endl;
+				}
+			}
+		}
+		else {
+			cout << "no dual ray available" << endl;
+		}
+		SCIPwriteOrigProblem(scip->getScip(), "debug.lp", NULL, TRUE);
+	}
+#endif
+	assert(scip->isOptimal());
+	opt = scip->getObjectiveValue();
+
+	a->setObj(0);
+	return FVABound(opt, FVA_CIP);
+}
+
+ScipModelPtr TFVAWorker::buildCIP() {
+	if(_settings->persistent && _cip.use_count() > 0) {
+		_cip->freeTransform();
+		_cip->updateFromModel();
+		return _cip;
+	}
+
+	ScipModelPtr scip = _factory.build(_model);
+	_boundReached = createBoundReachedEventHandler(scip);
+	if(_settings->race_after >= 0 || _settings->cancellation) {
+		_interrupt = createInterruptEventHandler(scip, _settings->cancellation);
+	}
+	if(_settings->persistent || _sharedCoupling) {
+		// presolving reductions derive coupling information that is kept for later solves (or shared with other CIPs), so they must not depend on the objective
+#if SCIP_VERSION >= 700
+		BOOST_SCIP_CALL( SCIPsetBoolParam(scip->getScip(), "misc/allowstrongdualreds", FALSE) );
+		BOOST_SCIP_CALL( SCIPsetBoolParam(scip->getScip(), "misc/allowweakdualreds", FALSE) );
+#else
+		BOOST_SCIP_CALL( SCIPsetBoolParam(scip->getScip(), "misc/allowdualreds", FALSE) );
+#endif
+	}
+	if(_settings->persistent) {
+		_cip = scip;
+	}
+	return scip;
+}
+
+bool TFVAWorker::race(ScipModelPtr scip, bool maximize, double timelimit, double& opt) {
+	double headstart = _settings->race_after;
+	if(headstart < 0 || (timelimit > 1 && timelimit <= headstart)) {
+		// no race
+		scip->solve();
+		return false;
+	}
+
+	// most CIPs are solved quickly, only start the race for the hard ones
+	BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", headstart) );
+	scip->solve();
+	if(SCIPgetStatus(scip->getScip()) != SCIP_STATUS_TIMELIMIT) {
+		return false;
+	}
+	// the time limit refers to the total solving time, so scip can simply continue with the original one
+	if(timelimit > 1) {
+		BOOST_SCIP_CALL( SCIPsetRealParam(scip->getScip(), "limits/time", timelimit) );
+	}
+	else {
+		BOOST_SCIP_CALL( SCIPresetParam(scip->getScip(), "limits/time") );
+	}
+
+	// the alternative formulation works on its own copy of the model, so that both CIPs can be solved at the same time
+	unordered_map<ReactionPtr, ReactionPtr> rxns;
+	unordered_map<MetabolitePtr, MetabolitePtr> mets;
+	ModelPtr model = copyModel(_model, rxns, mets);
+	FVADirectionsModelFactory factory;
+	foreach(FluxConstraintPtr c, _factory.fluxConstraints) {
+		FluxConstraintPtr copy(new FluxConstraint(*c));
+		copy->coef.clear();
+		typedef pair<const ReactionPtr, double> Coef;
+		foreach(const Coef& e, c->coef) {
+			copy->coef[rxns.at(e.first)] = e.second;
+		}
+		factory.fluxConstraints.push_back(copy);
+	}
+	ScipModelPtr alt = factory.build(model);
+	alt->setObjectiveSense(maximize);
+	if(timelimit > 1) {
+		BOOST_SCIP_CALL( SCIPsetRealParam(alt->getScip(), "limits/time", std::max(1.0, timelimit - headstart)) );
+	}
+	LPPotentialsPtr potTest(new LPPotentials(model));
+
+	CancellationTokenPtr stopCIP(new CancellationToken());
+	CancellationTokenPtr stopAlt(new CancellationToken());
+	_interrupt->setFlag(stopCIP);
+	createInterruptEventHandler(alt, _settings->cancellation)->setFlag(stopAlt);
+
+	bool won = false;
+	double altOpt = 0;
+	std::exception_ptr error;
+	std::thread second([&]() {
+		try {
+			alt->solve();
+			if(alt->isOptimal()) {
+				/*
+				 * The direction variables are only linked to the potentials by a relaxation,
+				 * so the optimum of alt is only the thermodynamically feasible optimum, if it passes the strict test.
+				 */
+				bool feasible;
+				potTest->setDirections(wrap_weak(SCIPgetBestSol(alt->getScip())), alt);
+				if(potTest->testStrictFeasible(feasible) && feasible) {
+					altOpt = alt->getObjectiveValue();
+					won = true;
+					stopCIP->cancel();
+				}
+			}
+		}
+		catch(...) {
+			error = std::current_exception();
+		}
+	});
+
+	try {
+		scip->solve();
+	}
+	catch(...) {
+		stopAlt->cancel();
+		second.join();
+		_interrupt->setFlag(CancellationTokenPtr());
+		throw;
+	}
+	stopAlt->cancel();
+	second.join();
+	_interrupt->setFlag(CancellationTokenPtr());
+	if(error) {
+		std::rethrow_exception(error);
+	}
+
+	SCIP_STATUS status = SCIPgetStatus(scip->getScip());
+	bool finished = status != SCIP_STATUS_TIMELIMIT && (status != SCIP_STATUS_USERINTERRUPT || _boundReached->isReached(scip->getPrimalBound()));
+	if(won && !finished) {
+		opt = altOpt;
+		return true;
+	}
+	return false;
+}
+
+void TFVAWorker::addWitness(LPFluxPtr flux) {
+	vector<double> witness;
+	witness.reserve(_poolReactions.size());
+	foreach(ReactionPtr r, _poolReactions) {
+		witness.push_back(flux->getFlux(r));
+	}
+	_pool->add(witness);
+}
+
+bool TFVAWorker::injectWitnesses(ScipModelPtr scip, unsigned int i, bool maximize) {
+	vector<vector<double> > witnesses;
+	_pool->getBest(_poolIndex.at(i), maximize, NUM_START_SOLUTIONS, witnesses);
+	if(witnesses.empty() || scip->hasPotentials()) {
+		// we only store fluxes, so we cannot complete solutions with explicit potential variables
+		return false;
+	}
+
+	bool accepted = false;
+	SCIP* s = scip->getScip();
+	BOOST_SCIP_CALL( SCIPtransformProb(s) );
+	foreach(vector<double>& w, witnesses) {
+		SCIP_SOL* sol;
+		BOOST_SCIP_CALL( SCIPcreateOrigSol(s, &sol, NULL) );
+		for(unsigned int j = 0; j < _poolReactions.size(); j++) {
+			ReactionPtr r = _poolReactions[j];
+			if(scip->hasFluxVar(r)) {
+				BOOST_SCIP_CALL( SCIPsetSolVal(s, sol, scip->getFlux(r), w[j]) );
+			}
+		}
+		// the bounds may have been tightened since the witness was found, so everything has to be checked
+		unsigned int stored;
+		BOOST_SCIP_CALL( SCIPtrySolFree(s, &sol, FALSE, FALSE, TRUE, TRUE, TRUE, &stored) );
+		accepted = accepted || stored;
+	}
+	return accepted;
+}
+
+void TFVAWorker::harvestWitnesses(ScipModelPtr scip) {
+	SCIP* s = scip->getScip();
+	int nsols = SCIPgetNSols(s);
+	SCIP_SOL** sols = SCIPgetSols(s); // sorted by objective value, best first
+	for(int k = 0; k < nsols && k < NUM_HARVESTED_SOLUTIONS; k++) {
+		vector<double> witness;
+		witness.reserve(_poolReactions.size());
+		foreach(ReactionPtr r, _poolReactions) {
+			witness.push_back(scip->hasFluxVar(r) ? SCIPgetSolVal(s, sols[k], scip->getFlux(r)) : 0);
+		}
+		_pool->add(witness);
+	}
+}
+
+bool TFVAWorker::screen(unsigned int i, bool maximize, double& value) {
+	ReactionPtr a = _reactions.at(i);
+	LPFluxPtr flux = maximize ? _max_flux : _min_flux;
+
+	if(_settings->deterministic) {
+		// the warm start must not depend on the tasks this worker solved before
+		_max_flux->resetState();
+		_min_flux->resetState();
+		_helper->resetState();
+		if(_potTest) {
+			_potTest->resetState();
+		}
+	}
+
+	a->setObj(1);
+	flux->setObj(a,1);
+	flux->solvePrimal();
+#ifndef NDEBUG
+	if(flux->isOptimal()) {
+		cout << (maximize ? "max " : "min ") << a->getName() << " opt-flux = " << flux->getObjVal() << endl;
+	}
+#endif
+
+	bool settled = false;
+	if(flux->isOptimal()) {
+		value = flux->getObjVal();
+		// for shortcut looplessflux must always be attainable
+		// if it is simple, it is sufficient, else we have to do more
+		settled = isLooplessFluxAttainable(flux, _helper) && (_simple || isThermoFluxAttainable(flux, _helper, _potTest, _settings->cancellation));
+		if(settled && !_simple && _pool) {
+			// isThermoFluxAttainable removed the cycles from the LP solution, so it is thermodynamically feasible now
+			addWitness(flux);
+		}
+	}
+	else {
+		value = maximize ? INFINITY : -INFINITY;
+	}
+
+	/*
+	 * reset objective function
+	 */
+	flux->setObj(a,0);
+	a->setObj(0);
+
+	return settled;
+}
+
+FVABound TFVAWorker::solve(unsigned int i, bool maximize) {
+	ReactionPtr a = _reactions.at(i);
+	PrecisionPtr prec = _model->getFluxPrecision();
+
+	double opt;
+	FVAStatus status = FVA_LP;
+	if(!screen(i, maximize, opt)) {
+		FVABound bound = solveCIP(i, maximize, _settings->timeout, opt); // the LP optimum bounds the CIP optimum
+		if(bound.status != FVA_CIP) {
+			// the LP optimum may still be the better outer bound
+			bound.outer = maximize ? std::min(bound.outer, opt) : std::max(bound.outer, opt);
+			return bound;
+		}
+		status = FVA_CIP;
+		opt = bound.outer;
+	}
+
+	if(_settings->reduce_domain) {
+		// we computed an exact bound, so use it for future computations
+		tighten(i, maximize ? -INFINITY : opt, maximize ? opt : INFINITY);
+	}
+
+	/*
+	 * Actually, we are now adding constraints and not decrease the precision.
+	 * This ok, since we solve with high dual precision.
+	 * This means, the error that we do is rather in primal infeasibilities than in dual infeasibilities,
+	 * i.e. the bounds that we compute tend to be a bit weaker.
+	 * In particular it is unlikely that they are overtight and produce infeasibilities.
+	 */
+	if(maximize && _max_flux->getUb(a) > opt + prec->getCheckTol()) {
+		_max_flux->setUb(a, opt);
+		_min_flux->setUb(a, opt);
+		_max_flux->solveDual();
+		_min_flux->solveDual();
+	}
+	else if(!maximize && _min_flux->getLb(a) < opt - prec->getCheckTol()) {
+		_max_flux->setLb(a, opt);
+		_min_flux->setLb(a, opt);
+		_max_flux->solveDual();
+		_min_flux->solveDual();
+	}
+
+	return FVABound(opt, status);
+}
+
+void TFVAWorker::tighten(unsigned int i, double lb, double ub) {
+	ReactionPtr a = _reactions.at(i);
+	// the model copy has the dual slave precision of the original model (see constructor), so this is the check tolerance of the dual slave precision
+	double margin = _model->getFluxPrecision()->getCheckTol();
+	ub += margin;
+	lb -= margin;
+
+	// the LPs may already have tighter bounds than the model copy (see solve), so check separately
+	if(ub < a->getUb()) {
+		a->setUb(ub);
+	}
+	if(ub < _max_flux->getUb(a)) {
+		_max_flux->setUb(a, ub);
+		_min_flux->setUb(a, ub);
+	}
+	if(lb > a->getLb()) {
+		a->setLb(lb);
+	}
+	if(lb > _min_flux->getLb(a)) {
+		_max_flux->setLb(a, lb);
+		_min_flux->setLb(a, lb);
+	}
+}
+
+void TFVAWorker::addFluxConstraint(FluxConstraintPtr c) {
+	assert(_cip.use_count() == 0);
+	FluxConstraintPtr copy(new FluxConstraint());
+	copy->lhs = c->lhs;
+	copy->rhs = c->rhs;
+	typedef pair<const ReactionPtr, double> Coef;
+	foreach(const Coef& e, c->coef) {
+		ReactionPtr r = _toCopy.at(e.first);
+		copy->coef[r] = e.second;
+		// removing cycles through r could violate the constraint (see isLooplessFluxAttainable)
+		r->setProblematic(true);
+	}
+	_max_flux->addFluxConstraint(copy);
+	_min_flux->addFluxConstraint(copy);
+	_factory.fluxConstraints.push_back(copy);
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,234 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * TFVAWorker.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef TFVAWORKER_H_
+#define TFVAWORKER_H_
+
+#include <vector>
+
+#include "model/Model.h"
+#include "model/Coupling.h"
+#include "model/FluxConstraint.h"
+#include "model/SharedCoupling.h"
+#include "model/scip/LPFlux.h"
+#include "model/scip/LPPotentials.h"
+#include "model/scip/ThermoFeasibilityCache.h"
+#include "scip/constraints/SharedInfeasibleSetPool.h"
+#include "algorithms/ModelFactory.h"
+#include "algorithms/FVA.h"
+#include "algorithms/WitnessPool.h"
+#include "scip/event/BoundReachedEventHandler.h"
+#include "scip/event/InterruptEventHandler.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Builds the CIPs solved by thermodynamic FVA:
+ * steady-state, thermodynamic constraints and the cycle deletion heuristic.
+ */
+class FVAThermoModelFactory : public ModelFactory {
+public:
+	CouplingPtr coupling;
+	ThermoFeasibilityCachePtr feasibilityCache; // shared by the thermo constraint and the cycle deletion heuristic, may be empty
+	SharedInfeasibleSetPoolPtr infeasibleSetPool; // infeasible sets shared by the thermo constraints, may be empty
+	std::vector<FluxConstraintPtr> fluxConstraints; // extra constraints on the fluxes, added as linear constraints
+
+	ScipModelPtr build(ModelPtr m);
+};
+
+/**
+ * Builds an alternative formulation of the CIPs solved by thermodynamic FVA:
+ * steady-state and a direction variable for every internal reaction that is linked to the difference of the potentials (see ReactionDirections).
+ * It has a very different branching behavior, so it is raced against the CIPs of FVAThermoModelFactory on hard reactions (see FVASettings::race_after).
+ */
+class FVADirectionsModelFactory : public ModelFactory {
+public:
+	std::vector<FluxConstraintPtr> fluxConstraints; // extra constraints on the fluxes, added as linear constraints
+
+	ScipModelPtr build(ModelPtr m);
+};
+
+/**
+ * A TFVAWorker holds everything that is needed to compute the thermodynamic flux variability of single reactions.
+ *
+ * Since the LPs, CIPs and even the Model get modified during the computation,
+ * every worker operates on its own copy of the model and owns its own LPs and SCIP instances.
+ * Hence, different workers can be run in different threads without any synchronization.
+ *
+ * In persistent mode (FVASettings::persistent), the worker builds a single CIP and solves it again for every reaction,
+ * only exchanging objective, sense and bounds. This saves setting up SCIP, its plugins and the helper LPs of the constraint handler,
+ * and the coupling information learned in presolving is kept.
+ * Since that information must be valid for all objectives, dual reductions are disabled in this mode.
+ *
+ * If a WitnessPool is given, the thermodynamically feasible fluxes found by the worker are added to the pool
+ * and the best fluxes of the pool are passed to every CIP as start solutions.
+ *
+ * If a ThermoFeasibilityCache is given, the feasibility tests of the worker's LPs and CIPs are shared with all other users of the cache.
+ * Likewise, if a SharedInfeasibleSetPool is given, the infeasible sets found by the CIPs of the worker are used by all other CIPs of the run.
+ *
+ * If a SharedCoupling is given, the couplings the CIPs of the worker learn in presolving are collected in it,
+ * and every CIP starts from the couplings collected so far. As in persistent mode, dual reductions are disabled for this.
+ *
+ * If FVASettings::race_after is set, a CIP that is not solved within that time gets company:
+ * the alternative formulation of FVADirectionsModelFactory is solved in a second thread on its own copy of the model,
+ * and the first of both CIPs that proves optimality interrupts the other one.
+ * Hence, while racing, a worker uses two cores.
+ */
+class TFVAWorker : Uncopyable {
+public:
+	/**
+	 * Creates a new worker.
+	 *
+	 * @param model the model to analyze, it is copied and not modified by the worker
+	 * @param reactions the reactions to analyze, the worker refers to them by their index in this list
+	 * @param settings the settings of the tFVA run
+	 * @param pool pool of feasible fluxes shared by all workers, may be empty
+	 * @param cache results of thermodynamic feasibility tests shared by all workers, may be empty
+	 * @param infeasibleSets infeasible sets shared by all workers, may be empty
+	 * @param coupling couplings learned by all workers, may be empty
+	 */
+	TFVAWorker(ModelPtr model, const std::vector<ReactionPtr>& reactions, FVASettingsPtr settings, WitnessPoolPtr pool = WitnessPoolPtr(), ThermoFeasibilityCachePtr cache = ThermoFeasibilityCachePtr(), SharedInfeasibleSetPoolPtr infeasibleSets = SharedInfeasibleSetPoolPtr(), SharedCouplingPtr coupling = SharedCouplingPtr());
+	virtual ~TFVAWorker();
+
+	/**
+	 * Computes the maximal (or minimal) thermodynamically feasible flux through the reaction with index i.
+	 * The computed bound is also used to tighten the LPs of this worker.
+	 * If FVASettings::reduce_domain is set, it is also used to tighten the domain of the CIPs (see tighten).
+	 * If the CIP hits the time limit (FVASettings::timeout), only an interval is known and the bound has status FVA_BOUNDED.
+	 * Such a bound is not used to tighten anything.
+	 */
+	FVABound solve(unsigned int i, bool maximize);
+
+	/**
+	 * Tries to compute the maximal (or minimal) thermodynamically feasible flux through the reaction with index i by solving an LP only.
+	 *
+	 * @param value receives the optimal LP value, which is a valid bound on the thermodynamically feasible flux
+	 * (infinite if the LP could not be solved to optimality).
+	 * @return true, if the LP shortcut succeeded and value is the optimal thermodynamically feasible flux.
+	 */
+	bool screen(unsigned int i, bool maximize, double& value);
+
+	/**
+	 * Solves the CIP of the reaction with index i with the given time limit in seconds (no limit if it is less than one second).
+	 * If the time limit is hit, the dual bound and the best solution found are returned with status FVA_BOUNDED.
+	 *
+	 * @param bound a known bound on the optimum (e.g. the LP optimum), the solving process stops as soon as a solution attains it
+	 */
+	FVABound solveCIP(unsigned int i, bool maximize, double timelimit, double bound);
+
+	/**
+	 * Tightens the bounds of the reaction with index i in the model copy and the LPs of this worker.
+	 * A margin of the check tolerance is added, so that numerical errors cannot render the problem infeasible.
+	 * Bounds are never relaxed.
+	 *
+	 * Since no thermodynamically feasible flux exceeds the minimal and maximal thermodynamically feasible flux of a reaction,
+	 * tightening with those values (or with any valid bound on them) does not change the result of later computations.
+	 * Only the worker's own copy of the model is modified.
+	 */
+	void tighten(unsigned int i, double lb, double ub);
+
+	/**
+	 * Restricts all later computations of this worker to the fluxes satisfying c (e.g. to the optimal flux space).
+	 * The reactions of c belong to the original model, they are translated to the model copy and marked as problematic there.
+	 * This must be called before the first CIP is solved.
+	 */
+	void addFluxConstraint(FluxConstraintPtr c);
+
+private:
+	ModelPtr _model; // private copy of the model
+	std::vector<ReactionPtr> _reactions; // reactions of _model in the order given in the constructor
+	FVASettingsPtr _settings;
+	bool _simple; // no potential bounds are given, so loopless FVA is sufficient
+
+	LPFluxPtr _max_flux; // LP for maximizing fluxes
+	LPFluxPtr _min_flux; // LP for minimizing fluxes
+	LPFluxPtr _helper; // tests if the LP solution is already optimal
+	LPPotentialsPtr _potTest; // tests if the LP solution is thermodynamically feasible (only if !_simple)
+
+	FVAThermoModelFactory _factory;
+	ScipModelPtr _cip; // CIP that is reused for all reactions (only if _settings->persistent)
+	BoundReachedEventHandler* _boundReached; // event handler of the last built CIP, owned by SCIP
+	InterruptEventHandler* _interrupt; // event handler of the last built CIP that stops it if the run is cancelled or it loses a race, owned by SCIP (only if needed)
+
+	WitnessPoolPtr _pool;
+	std::vector<ReactionPtr> _poolReactions; // reactions of _model in the order of _pool->getReactions()
+	std::vector<unsigned int> _poolIndex; // index of _reactions[i] in _poolReactions
+
+	SharedCouplingPtr _sharedCoupling;
+	boost::unordered_map<ReactionPtr, ReactionPtr> _toCopy; // original reactions to reactions of _model
+	boost::unordered_map<ReactionPtr, ReactionPtr> _toOriginal; // reactions of _model to original reactions (only if _sharedCoupling is set)
+	unsigned int _sharedPosition; // number of couplings of _sharedCoupling already added to the coupling of _factory
+
+	/**
+	 * Returns a CIP for the current objective and bounds of the model copy.
+	 * In persistent mode, the existing CIP is reset and updated instead of building a new one.
+	 */
+	ScipModelPtr buildCIP();
+
+	/**
+	 * Solves the CIP scip.
+	 * If it is not solved within FVASettings::race_after seconds, the alternative formulation is raced against it.
+	 *
+	 * @param opt receives the optimum, if the alternative formulation won
+	 * @return true, if the alternative formulation won and scip was interrupted
+	 */
+	bool race(ScipModelPtr scip, bool maximize, double timelimit, double& opt);
+
+	/**
+	 * Adds the current solution of flux to the witness pool.
+	 */
+	void addWitness(LPFluxPtr flux);
+
+	/**
+	 * Passes the best witnesses for the objective of the reaction with index i to scip as start solutions.
+	 * This transforms the problem.
+	 *
+	 * @return true, if at least one witness was accepted
+	 */
+	bool injectWitnesses(ScipModelPtr scip, unsigned int i, bool maximize);
+
+	/**
+	 * Adds the best solutions found by scip to the witness pool.
+	 */
+	void harvestWitnesses(ScipModelPtr scip);
+
+};
+
+typedef boost::shared_ptr<TFVAWorker> TFVAWorkerPtr;
+
+/**
+ * checks if a loopless free flux with the same objective value can be attained
+ */
+bool isLooplessFluxAttainable(LPFluxPtr sol, LPFluxPtr helper);
+
+/**
+ * checks if a thermodynamically feasible flux with the same objective value can be attained
+ * Throws a CancelledError, if token is cancelled while cycles are subtracted.
+ */
+bool isThermoFluxAttainable(LPFluxPtr sol, LPFluxPtr helper, LPPotentialsPtr potTest, CancellationTokenPtr token = CancellationTokenPtr());
+
+} /* namespace metaopt */
+#endif /* TFVAWORKER_H_ */
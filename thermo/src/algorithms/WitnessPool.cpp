@@ -0,0 +1,88 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WitnessPool.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <algorithm>
+#include <math.h>
+
+#include "WitnessPool.h"
+#include "model/Reaction.h"
+
+namespace metaopt {
+
+WitnessPool::WitnessPool(ModelPtr model, unsigned int capacity) :
+		_reactions(model->getReactions().begin(), model->getReactions().end()),
+		_capacity(capacity),
+		_tol(model->getFluxPrecision()->getCheckTol()) {
+	// nothing to do
+}
+
+WitnessPool::~WitnessPool() {
+	// nothing to do
+}
+
+const std::vector<ReactionPtr>& WitnessPool::getReactions() const {
+	return _reactions;
+}
+
+void WitnessPool::add(const std::vector<double>& flux) {
+	assert(flux.size() == _reactions.size());
+	if(_capacity == 0) return;
+
+	std::lock_guard<std::mutex> guard(_lock);
+	foreach(const std::vector<double>& w, _witnesses) {
+		bool same = true;
+		for(unsigned int j = 0; same && j < w.size(); j++) {
+			same = fabs(w[j] - flux[j]) <= _tol;
+		}
+		if(same) return;
+	}
+	if(_witnesses.size() >= _capacity) {
+		_witnesses.pop_front();
+	}
+	_witnesses.push_back(flux);
+}
+
+void WitnessPool::getBest(unsigned int index, bool maximize, unsigned int count, std::vector<std::vector<double> >& witnesses) {
+	assert(index < _reactions.size());
+	std::lock_guard<std::mutex> guard(_lock);
+
+	// sort witnesses by their objective value (best first)
+	std::vector<std::pair<double, unsigned int> > order;
+	for(unsigned int k = 0; k < _witnesses.size(); k++) {
+		double val = _witnesses[k][index];
+		order.push_back(std::make_pair(maximize ? -val : val, k));
+	}
+	std::sort(order.begin(), order.end());
+
+	for(unsigned int k = 0; k < order.size() && k < count; k++) {
+		witnesses.push_back(_witnesses[order[k].second]);
+	}
+}
+
+unsigned int WitnessPool::size() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _witnesses.size();
+}
+
+} /* namespace metaopt */
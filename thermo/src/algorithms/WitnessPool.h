@@ -0,0 +1,92 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WitnessPool.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef WITNESSPOOL_H_
+#define WITNESSPOOL_H_
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+
+#include "model/Model.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * A bounded pool of distinct thermodynamically feasible fluxes (witnesses) found during a tFVA run.
+ *
+ * Every feasible flux is a feasible solution for every later CIP of the same run,
+ * so the best witnesses for the current objective can be used as start solutions.
+ * A witness is stored as vector of flux values in the order of getReactions().
+ * Since the workers operate on copies of the model, they have to translate the reactions of their copy to this order.
+ *
+ * If the pool is full, the oldest witness is replaced.
+ * All methods are thread safe.
+ */
+class WitnessPool : Uncopyable {
+public:
+	/**
+	 * Creates a pool for fluxes of the given model, holding at most capacity witnesses.
+	 */
+	WitnessPool(ModelPtr model, unsigned int capacity);
+	virtual ~WitnessPool();
+
+	/**
+	 * Returns the reactions in the order that is used for the flux vectors.
+	 */
+	const std::vector<ReactionPtr>& getReactions() const;
+
+	/**
+	 * Adds a feasible flux to the pool.
+	 * If the pool already contains the same flux (up to the check tolerance of the model), nothing happens.
+	 */
+	void add(const std::vector<double>& flux);
+
+	/**
+	 * Fetches the count best witnesses for maximizing (or minimizing) the flux through the reaction with the given index.
+	 * The best witness comes first.
+	 */
+	void getBest(unsigned int index, bool maximize, unsigned int count, std::vector<std::vector<double> >& witnesses);
+
+	/**
+	 * Returns the number of witnesses in the pool.
+	 */
+	unsigned int size();
+
+private:
+	std::vector<ReactionPtr> _reactions;
+	unsigned int _capacity;
+	double _tol;
+
+	std::mutex _lock; // protects _witnesses
+	std::deque<std::vector<double> > _witnesses;
+};
+
+typedef boost::shared_ptr<WitnessPool> WitnessPoolPtr;
+
+} /* namespace metaopt */
+#endif /* WITNESSPOOL_H_ */
@@ -0,0 +1,71 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WorkStealingScheduler.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "WorkStealingScheduler.h"
+
+namespace metaopt {
+
+WorkStealingScheduler::WorkStealingScheduler(unsigned int num_workers, bool stealing) : _stealing(stealing) {
+	assert(num_workers > 0);
+	for(unsigned int i = 0; i < num_workers; i++) {
+		_queues.push_back(boost::shared_ptr<Queue>(new Queue()));
+	}
+}
+
+WorkStealingScheduler::~WorkStealingScheduler() {
+	// nothing to do
+}
+
+void WorkStealingScheduler::push(unsigned int worker, unsigned int task) {
+	Queue& queue = *_queues.at(worker);
+	std::lock_guard<std::mutex> guard(queue.lock);
+	queue.tasks.push_back(task);
+}
+
+bool WorkStealingScheduler::popFront(Queue& queue, unsigned int& task) {
+	std::lock_guard<std::mutex> guard(queue.lock);
+	if(queue.tasks.empty()) {
+		return false;
+	}
+	task = queue.tasks.front();
+	queue.tasks.pop_front();
+	return true;
+}
+
+bool WorkStealingScheduler::pop(unsigned int worker, unsigned int& task) {
+	// first try own queue, then try to steal, starting with the next worker
+	unsigned int num_queues = _stealing ? _queues.size() : 1;
+	for(unsigned int i = 0; i < num_queues; i++) {
+		if(popFront(*_queues[(worker + i) % _queues.size()], task)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+unsigned int WorkStealingScheduler::getNumWorkers() const {
+	return _queues.size();
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,94 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * WorkStealingScheduler.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef WORKSTEALINGSCHEDULER_H_
+#define WORKSTEALINGSCHEDULER_H_
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Distributes tasks (identified by their index) on a fixed number of workers.
+ *
+ * Every worker has its own queue of tasks, which it processes from the front.
+ * If the queue of a worker runs empty, it steals from the other queues.
+ * Thieves also take the front task of their victim, i.e. the task that the victim would have processed next.
+ * Since tasks are queued in order of decreasing expected cost, this ensures that expensive tasks never wait behind a long running task.
+ *
+ * Each queue is protected by its own lock, which is only held for a single push or pop operation.
+ *
+ * Stealing can be switched off, so that every task is processed by the worker it was pushed to.
+ * Then the tasks of a worker and their order are fixed in advance, independent of the run times of the tasks.
+ */
+class WorkStealingScheduler : Uncopyable {
+public:
+	/**
+	 * @param num_workers number of workers
+	 * @param stealing if false, workers only process the tasks of their own queue
+	 */
+	WorkStealingScheduler(unsigned int num_workers, bool stealing = true);
+	virtual ~WorkStealingScheduler();
+
+	/**
+	 * Appends a task to the queue of the given worker.
+	 */
+	void push(unsigned int worker, unsigned int task);
+
+	/**
+	 * Fetches the next task for the given worker.
+	 * If the queue of the worker is empty, a task is stolen from another worker (if stealing is enabled).
+	 *
+	 * @return false, if there is no task left.
+	 */
+	bool pop(unsigned int worker, unsigned int& task);
+
+	/**
+	 * Returns the number of workers.
+	 */
+	unsigned int getNumWorkers() const;
+
+private:
+	struct Queue {
+		std::mutex lock;
+		std::deque<unsigned int> tasks;
+	};
+
+	std::vector<boost::shared_ptr<Queue> > _queues;
+	bool _stealing;
+
+	/**
+	 * pops the front task of the given queue
+	 */
+	bool popFront(Queue& queue, unsigned int& task);
+};
+
+} /* namespace metaopt */
+#endif /* WORKSTEALINGSCHEDULER_H_ */
@@ -53,10 +53,10 @@ Coupling::Coupling(const Coupling &c) {
 	// add the links
 	foreach(NodeEntry e, c._nodes) {
 		const NodePtr& n = _nodes[e.first];
-		foreach(Node* k, n->_to) {
+		foreach(Node* k, e.second->_to) {
 			n->_to.insert(_nodes[k->_reaction].get());
 		}
-		foreach(Node* k, n->_from) {
+		foreach(Node* k, e.second->_from) {
 			n->_from.insert(_nodes[k->_reaction].get());
 		}
 		// color and finish time we don't have to set, since they are set in the algorithm when needed
@@ -81,7 +81,7 @@ std::size_t Coupling::hash_value(StrongComponent* p ) {
 
 Coupling::Node::Node(DirectedReaction& d) : _reaction(d) {}
 
-void Coupling::addCoupled(DirectedReaction a, DirectedReaction b) {
+bool Coupling::addCoupled(DirectedReaction a, DirectedReaction b) {
 
 	// use the property that unordered_map allocates new objects if it doesn't find them
 	NodePtr& na = _nodes[a];
@@ -95,10 +95,13 @@ void Coupling::addCoupled(DirectedReaction a, DirectedReaction b) {
 		nb.reset(new Node(b));
 	}
 
-	na->_to.insert(nb.get());
+	if(!na->_to.insert(nb.get()).second) {
+		return false; // already known, so the closure is still valid
+	}
 	nb->_from.insert(na.get());
 
 	israw = true;
+	return true;
 }
 
 void Coupling::dfs(Node* node, unsigned int &time) {
@@ -124,6 +127,8 @@ void Coupling::dfs2(Node* node, const StrongComponentPtr & comp) {
 }
 
 void Coupling::computeClosure() {
+	if(!israw) return; // no new couplings since the last computation
+
 #ifndef SILENT
 	cout << "starting compute closure... ";
 	cout.flush();
@@ -205,11 +210,26 @@ void Coupling::computeClosure() {
 }
 
 
+void Coupling::getDirectCouplings(vector<pair<DirectedReaction, DirectedReaction> >& couplings) const {
+	typedef pair<DirectedReaction, NodePtr> NodeEntry;
+	foreach(const NodeEntry& e, _nodes) {
+		foreach(Node* k, e.second->_to) {
+			couplings.push_back(pair<DirectedReaction, DirectedReaction>(e.first, k->_reaction));
+		}
+	}
+}
+
 bool Coupling::isCoupled(DirectedReaction a, DirectedReaction b) {
 	assert(!israw);
 
-	const StrongComponentPtr& sa = _components[a];
-	const StrongComponentPtr& sb = _components[b];
+	// do not use operator[], because it would insert empty components for unknown reactions, which would all be equal
+	unordered_map<DirectedReaction, StrongComponentPtr>::const_iterator ia = _components.find(a);
+	unordered_map<DirectedReaction, StrongComponentPtr>::const_iterator ib = _components.find(b);
+	if(ia == _components.end() || ib == _components.end()) {
+		return a == b;
+	}
+	const StrongComponentPtr& sa = ia->second;
+	const StrongComponentPtr& sb = ib->second;
 
 	return(sa == sb || sa->_coupledTo.find(sb.get()) != sa->_coupledTo.end());
 }
@@ -342,4 +362,23 @@ CouplingPtr Coupling::copy() const{
 	return res;
 }
 
+CouplingPtr Coupling::copy(const unordered_map<ReactionPtr, ReactionPtr>& translation) const {
+	CouplingPtr res(new Coupling());
+
+	typedef pair<DirectedReaction, NodePtr> NodeEntry;
+	foreach(NodeEntry e, _nodes) {
+		unordered_map<ReactionPtr, ReactionPtr>::const_iterator a = translation.find(e.first._rxn);
+		if(a == translation.end()) continue;
+		foreach(Node* k, e.second->_to) {
+			unordered_map<ReactionPtr, ReactionPtr>::const_iterator b = translation.find(k->_reaction._rxn);
+			if(b == translation.end()) continue;
+			res->addCoupled(DirectedReaction(a->second, e.first._fwd), DirectedReaction(b->second, k->_reaction._fwd));
+		}
+	}
+	if(!israw) {
+		res->computeClosure();
+	}
+	return res;
+}
+
 } /* namespace metaopt */
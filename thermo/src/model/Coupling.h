@@ -66,14 +66,22 @@ public:
 	 * Stores that a is directionally coupled to b.
 	 * This means that if a carries (positive) flux, also b carries (positive) flux.
 	 * This is the fast implementation that does not maintain transitive closure.
+	 *
+	 * @return true, if the coupling was not stored before
 	 */
-	void addCoupled(DirectedReaction a, DirectedReaction b);
+	bool addCoupled(DirectedReaction a, DirectedReaction b);
 
 	/**
 	 * Computes the transitive closure.
+	 * If no new couplings were added since the last computation, nothing is done.
 	 */
 	void computeClosure();
 
+	/**
+	 * Fetches all directly stored couplings (a, b), i.e. without the ones implied by transitivity.
+	 */
+	void getDirectCouplings(std::vector<std::pair<DirectedReaction, DirectedReaction> >& couplings) const;
+
 	/**
 	 * Checks, if a is directionally coupled to b.
 	 * This also uses the transitivity property of flux coupling.
@@ -101,6 +109,13 @@ public:
 	 */
 	boost::shared_ptr<Coupling> copy() const;
 
+	/**
+	 * copy this Coupling information onto another model.
+	 * Each reaction is replaced by its translation, couplings of reactions without translation are dropped.
+	 * Use this together with copyModel() to hand a coupling to a copy of the model.
+	 */
+	boost::shared_ptr<Coupling> copy(const boost::unordered_map<ReactionPtr, ReactionPtr>& translation) const;
+
 private:
 
 	// new implementation
@@ -0,0 +1,53 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * FluxConstraint.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef FLUXCONSTRAINT_H_
+#define FLUXCONSTRAINT_H_
+
+#include <math.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "model/Reaction.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * A linear constraint lhs <= sum_r coef[r] * v_r <= rhs on the fluxes, that is imposed in addition to steady-state and thermodynamics.
+ * The reactions involved in such a constraint should be marked as problematic (see Reaction::setProblematic),
+ * so that removing cycles from a flux does not violate the constraint.
+ */
+struct FluxConstraint {
+	boost::unordered_map<ReactionPtr, double> coef;
+	double lhs;
+	double rhs;
+
+	FluxConstraint() : coef(), lhs(-INFINITY), rhs(INFINITY) {};
+};
+
+typedef boost::shared_ptr<FluxConstraint> FluxConstraintPtr;
+
+} /* namespace metaopt */
+#endif /* FLUXCONSTRAINT_H_ */
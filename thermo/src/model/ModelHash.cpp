@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ModelHash.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <vector>
+#include <algorithm>
+#include <sstream>
+#include <iomanip>
+#include <stdint.h>
+
+#include "ModelHash.h"
+
+using namespace std;
+using namespace boost;
+
+namespace metaopt {
+
+// 64 bit FNV-1a, we cannot use boost::hash, because it may differ between platforms and versions
+#define FNV_OFFSET 14695981039346656037ULL
+#define FNV_PRIME 1099511628211ULL
+
+std::string hashModel(ModelPtr model) {
+	// describe every reaction and metabolite by a line of text and sort the lines to become independent of the creation order
+	vector<string> lines;
+	foreach(MetabolitePtr m, model->getMetabolites()) {
+		ostringstream ss;
+		ss << setprecision(17);
+		ss << "M\t" << m->getName() << '\t' << m->hasBoundaryCondition() << '\t' << m->getPotLb() << '\t' << m->getPotUb();
+		lines.push_back(ss.str());
+	}
+	foreach(ReactionPtr r, model->getReactions()) {
+		vector<string> coefs;
+		foreach(const Stoichiometry& s, r->getStoichiometries()) {
+			ostringstream cs;
+			cs << setprecision(17) << s.first->getName() << ':' << s.second;
+			coefs.push_back(cs.str());
+		}
+		std::sort(coefs.begin(), coefs.end());
+
+		ostringstream ss;
+		ss << setprecision(17);
+		ss << "R\t" << r->getName() << '\t' << r->isExchange() << '\t' << r->getLb() << '\t' << r->getUb();
+		foreach(const string& c, coefs) {
+			ss << '\t' << c;
+		}
+		lines.push_back(ss.str());
+	}
+	std::sort(lines.begin(), lines.end());
+
+	string data;
+	foreach(const string& line, lines) {
+		data += line;
+		data += '\n';
+	}
+	return hashString(data);
+}
+
+std::string hashString(const std::string& data) {
+	uint64_t hash = FNV_OFFSET;
+	foreach(char c, data) {
+		hash ^= (unsigned char) c;
+		hash *= FNV_PRIME;
+	}
+
+	ostringstream res;
+	res << hex << setw(16) << setfill('0') << hash;
+	return res.str();
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,54 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ModelHash.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef MODELHASH_H_
+#define MODELHASH_H_
+
+#include <string>
+
+#include "model/Model.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Computes a fingerprint of the flux space of the model that is stable across processes and machines.
+ *
+ * It covers names, flux bounds, stoichiometries, exchange flags, boundary conditions and potential bounds,
+ * but not objective coefficients and precisions (describeResultSettings covers the objective where it matters). It does not depend on the order in which reactions and metabolites were created.
+ * Use it to check that results computed by different runs belong to the same model.
+ *
+ * @return the hash as a string of 16 hexadecimal digits
+ */
+std::string hashModel(ModelPtr model);
+
+/**
+ * Computes a hash of the given data that is stable across processes and machines (64 bit FNV-1a).
+ *
+ * @return the hash as a string of 16 hexadecimal digits
+ */
+std::string hashString(const std::string& data);
+
+} /* namespace metaopt */
+#endif /* MODELHASH_H_ */
@@ -0,0 +1,75 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SharedCoupling.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "SharedCoupling.h"
+
+using namespace std;
+
+namespace metaopt {
+
+SharedCoupling::SharedCoupling() {
+	// nothing to do
+}
+
+SharedCoupling::~SharedCoupling() {
+	// nothing to do
+}
+
+unsigned int SharedCoupling::merge(const Coupling& coupling, const unordered_map<ReactionPtr, ReactionPtr>& translation) {
+	vector<Arc> arcs;
+	coupling.getDirectCouplings(arcs);
+
+	std::lock_guard<std::mutex> guard(_lock);
+	unsigned int added = 0;
+	foreach(const Arc& arc, arcs) {
+		unordered_map<ReactionPtr, ReactionPtr>::const_iterator a = translation.find(arc.first._rxn);
+		unordered_map<ReactionPtr, ReactionPtr>::const_iterator b = translation.find(arc.second._rxn);
+		if(a == translation.end() || b == translation.end()) continue;
+		Arc original(DirectedReaction(a->second, arc.first._fwd), DirectedReaction(b->second, arc.second._fwd));
+		if(_known.insert(original).second) {
+			_arcs.push_back(original);
+			added++;
+		}
+	}
+	return added;
+}
+
+unsigned int SharedCoupling::update(Coupling& coupling, const unordered_map<ReactionPtr, ReactionPtr>& translation, unsigned int position) {
+	std::lock_guard<std::mutex> guard(_lock);
+	for(unsigned int i = position; i < _arcs.size(); i++) {
+		const Arc& arc = _arcs[i];
+		unordered_map<ReactionPtr, ReactionPtr>::const_iterator a = translation.find(arc.first._rxn);
+		unordered_map<ReactionPtr, ReactionPtr>::const_iterator b = translation.find(arc.second._rxn);
+		if(a == translation.end() || b == translation.end()) continue;
+		coupling.addCoupled(DirectedReaction(a->second, arc.first._fwd), DirectedReaction(b->second, arc.second._fwd));
+	}
+	return _arcs.size();
+}
+
+unsigned int SharedCoupling::size() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _arcs.size();
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,87 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SharedCoupling.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef SHAREDCOUPLING_H_
+#define SHAREDCOUPLING_H_
+
+#include <vector>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "model/Coupling.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Collects the flux couplings learned by different CIPs of a run (e.g. from presolving aggregations),
+ * so that later CIPs start from the accumulated coupling graph.
+ *
+ * Couplings are stored for the reactions of the original model in the order they arrive.
+ * Users operating on copies of the model pass the translation between their reactions and the original ones.
+ * Since every user only fetches the couplings it has not seen yet, its closure only has to be recomputed if new couplings arrived.
+ *
+ * All methods are thread safe.
+ */
+class SharedCoupling : Uncopyable {
+public:
+	SharedCoupling();
+	virtual ~SharedCoupling();
+
+	/**
+	 * Adds the direct couplings of coupling, whose reactions are translated to the original reactions by translation.
+	 * Couplings of reactions without translation are dropped.
+	 *
+	 * @return the number of couplings that were not known before
+	 */
+	unsigned int merge(const Coupling& coupling, const boost::unordered_map<ReactionPtr, ReactionPtr>& translation);
+
+	/**
+	 * Adds all couplings that arrived after the given position to coupling, translating the original reactions by translation.
+	 *
+	 * @param position number of couplings the user already fetched (0 on the first call)
+	 * @return the new position to pass on the next call
+	 */
+	unsigned int update(Coupling& coupling, const boost::unordered_map<ReactionPtr, ReactionPtr>& translation, unsigned int position);
+
+	/**
+	 * Returns the number of collected couplings.
+	 */
+	unsigned int size();
+
+private:
+	typedef std::pair<DirectedReaction, DirectedReaction> Arc;
+
+	std::mutex _lock;
+	std::vector<Arc> _arcs; // in the order of arrival
+	boost::unordered_set<Arc> _known;
+};
+
+typedef boost::shared_ptr<SharedCoupling> SharedCouplingPtr;
+
+} /* namespace metaopt */
+#endif /* SHAREDCOUPLING_H_ */
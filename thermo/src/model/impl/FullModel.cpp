@@ -89,6 +89,35 @@ const unordered_set<MetabolitePtr>& FullModel::getMetabolites() const {
 	return _metabolites;
 }
 
+FullModelPtr copyModel(ModelPtr model, unordered_map<ReactionPtr, ReactionPtr>& reactions, unordered_map<MetabolitePtr, MetabolitePtr>& metabolites) {
+	FullModelPtr copy(new FullModel());
+	copy->setFluxPrecision(model->getFluxPrecision());
+	copy->setPotPrecision(model->getPotPrecision());
+	copy->setCoefPrecision(model->getCoefPrecision());
+
+	foreach(MetabolitePtr met, model->getMetabolites()) {
+		MetabolitePtr m = copy->createMetabolite(met->getName());
+		m->setPotLb(met->getPotLb());
+		m->setPotUb(met->getPotUb());
+		m->setPotObj(met->getPotObj());
+		m->setBoundaryCondition(met->hasBoundaryCondition());
+		metabolites[met] = m;
+	}
+	foreach(ReactionPtr rxn, model->getReactions()) {
+		ReactionPtr r = copy->createReaction(rxn->getName());
+		r->setLb(rxn->getLb());
+		r->setUb(rxn->getUb());
+		r->setObj(rxn->getObj());
+		r->setExchange(rxn->isExchange());
+		r->setProblematic(rxn->isProblematic());
+		foreach(Stoichiometry s, rxn->getStoichiometries()) {
+			r->setStoichiometry(metabolites.at(s.first), s.second);
+		}
+		reactions[rxn] = r;
+	}
+	return copy;
+}
+
 
 
 
@@ -26,6 +26,8 @@
 #ifndef FULLMODEL_H_
 #define FULLMODEL_H_
 
+#include <boost/unordered_map.hpp>
+
 #include "Properties.h"
 #include "model/Model.h"
 #include "Uncopyable.h"
@@ -112,5 +114,16 @@ private:
 
 typedef boost::shared_ptr<FullModel> FullModelPtr;
 
+/**
+ * Creates a deep copy of the given model.
+ * Names, bounds, objective coefficients, stoichiometries and precisions are copied,
+ * so that the copy can be modified (or solved in another thread) without affecting the original model.
+ *
+ * @param model the model to copy
+ * @param reactions receives for every reaction of model the corresponding reaction of the copy
+ * @param metabolites receives for every metabolite of model the corresponding metabolite of the copy
+ */
+FullModelPtr copyModel(ModelPtr model, boost::unordered_map<ReactionPtr, ReactionPtr>& reactions, boost::unordered_map<MetabolitePtr, MetabolitePtr>& metabolites);
+
 } /* namespace metaopt */
 #endif /* FULLMODEL_H_ */
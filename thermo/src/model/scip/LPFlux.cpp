@@ -41,10 +41,41 @@ typedef pair<ReactionPtr, int> VarAssign;
 
 LPFlux::LPFlux(ModelPtr model, bool exchange) {
 	_model = model;
+	_exchange = exchange;
 	BOOST_SCIP_CALL( init_lp(exchange) );
 	setPrecision(model->getFluxPrecision());
 }
 
+LPFluxPtr LPFlux::copy() {
+	LPFluxPtr res(new LPFlux(_model, _exchange));
+	res->setPrecision(_precision);
+
+	// the columns may be stored in a different order, so translate the indices (see setBounds)
+	double olb[_num_reactions];
+	double oub[_num_reactions];
+	double oobj[_num_reactions];
+	BOOST_SCIP_CALL( SCIPlpiGetBounds(_lpi, 0, _num_reactions-1, olb, oub) );
+	BOOST_SCIP_CALL( SCIPlpiGetObj(_lpi, 0, _num_reactions-1, oobj) );
+	int ind[res->_num_reactions];
+	double lb[res->_num_reactions];
+	double ub[res->_num_reactions];
+	double obj[res->_num_reactions];
+	foreach(VarAssign v, res->_reactions) {
+		int o = _reactions.at(v.first);
+		ind[v.second] = v.second;
+		lb[v.second] = olb[o];
+		ub[v.second] = oub[o];
+		obj[v.second] = oobj[o];
+	}
+	BOOST_SCIP_CALL( SCIPlpiChgBounds(res->_lpi, res->_num_reactions, ind, lb, ub) );
+	BOOST_SCIP_CALL( SCIPlpiChgObj(res->_lpi, res->_num_reactions, ind, obj) );
+	res->setObjSense(isMaximize());
+	foreach(FluxConstraintPtr c, _fluxConstraints) {
+		res->addFluxConstraint(c);
+	}
+	return res;
+}
+
 SCIP_RETCODE LPFlux::init_lp(bool exchange) {
 	_lpi = NULL;
 	SCIP_CALL( SCIPlpiCreate(&_lpi, NULL, "LPFlux", SCIP_OBJSEN_MAXIMIZE) );
@@ -554,7 +585,7 @@ double LPFlux::getDual(MetabolitePtr met) {
 		return 0; // the constraint does not exist, hence it is never active, hence its dual value is always 0
 	}
 	else {
-		double dualsol[_num_metabolites];
+		double dualsol[_num_metabolites + _fluxConstraints.size()];
 		BOOST_SCIP_CALL( SCIPlpiGetSol(_lpi, NULL, NULL, dualsol, NULL, NULL) );
 		return dualsol[iter->second];
 	}
@@ -763,6 +794,19 @@ vector<PotSpaceConstraintPtr> LPFlux::getActivePotConstraints() {
 }
 
 
+void LPFlux::addFluxConstraint(FluxConstraintPtr c) {
+	vector<int> ind;
+	vector<double> coef;
+	typedef pair<const ReactionPtr, double> Coef;
+	foreach(const Coef& e, c->coef) {
+		ind.push_back(_reactions.at(e.first));
+		coef.push_back(e.second);
+	}
+	int beg = 0;
+	BOOST_SCIP_CALL( SCIPlpiAddRows(_lpi, 1, &c->lhs, &c->rhs, NULL, ind.size(), &beg, ind.data(), coef.data()) );
+	_fluxConstraints.push_back(c);
+}
+
 #if 0
 	// these methods are for debugging only! A state of the LP can be stored and fetched later on
 	void LPFlux::loadState() {
@@ -38,6 +38,7 @@
 #include "Uncopyable.h"
 #include "model/scip/ISSupply.h"
 #include "model/scip/PotSpaceConstraint.h"
+#include "model/FluxConstraint.h"
 #include "model/Precision.h"
 #include "Properties.h"
 
@@ -56,6 +57,13 @@ public:
 	LPFlux(ModelPtr model, bool exchange);
 	virtual ~LPFlux();
 
+	/**
+	 * creates a new LPFlux on the same model with the same precision, bounds, objective and objective sense.
+	 * Extra flux constraints are copied, extra pot-space constraints and the basis are not.
+	 * Use this to give every thread its own LP.
+	 */
+	boost::shared_ptr<LPFlux> copy();
+
 	/**
 	 * Sets to solve with the desired precision.
 	 */
@@ -303,6 +311,12 @@ public:
 	 */
 	std::vector<PotSpaceConstraintPtr> getActivePotConstraints();
 
+	/**
+	 * Adds an extra constraint on the fluxes as a new row of the LP.
+	 * All reactions of the constraint must be part of the LP.
+	 */
+	void addFluxConstraint(FluxConstraintPtr c);
+
 	// only for debugging!
 	SCIP_LPI* getLPI();
 	int getIndex(ReactionPtr rxn);
@@ -323,6 +337,7 @@ public:
 
 private:
 	ModelPtr _model;
+	bool _exchange; //< the LP model contains exchange reactions
 	boost::unordered_map<ReactionPtr, int> _reactions; // in the internal LP problem, columns are only identified by indices, so we have to map reactions to indices
 	boost::unordered_map<MetabolitePtr, int> _metabolites; // in the internal LP problem, rows are only identified by indices, so we have to map metabolites to indices
 	SCIP_LPI* _lpi; //< internal LP problem
@@ -342,6 +357,7 @@ private:
 	SCIP_RETCODE free_lp();
 
 	boost::unordered_map<PotSpaceConstraintPtr, int> _extraConstraints;
+	std::vector<FluxConstraintPtr> _fluxConstraints; // extra rows behind the rows of the metabolites
 
 };
 
@@ -24,6 +24,7 @@
  */
 
 #include <vector>
+#include <algorithm>
 #include "LPPotentials.h"
 #include "Properties.h"
 
@@ -92,12 +93,14 @@ SCIP_RETCODE LPPotentials::init_lp() {
 			}
 			double lhs = -INFINITY;
 			double rhs = INFINITY;
+			int side = 0;
 			if(r->isFwdForcing()) {
 				//rhs = -REACTION_DIRECTIONS_EPSILON;
 				rhs = 0;
 				// also add the variable to test strict feasibility
 				ind.push_back(FEASTEST_VAR);
 				coef.push_back(1);
+				side = 1;
 			}
 			if(r->isBwdForcing()) {
 				//lhs = REACTION_DIRECTIONS_EPSILON;
@@ -105,7 +108,10 @@ SCIP_RETCODE LPPotentials::init_lp() {
 				// also add the variable to test strict feasibility
 				ind.push_back(FEASTEST_VAR);
 				coef.push_back(-1);
+				side = -1;
 			}
+			_side.push_back(side);
+			_strict.push_back(side);
 			int beg = 0;
 			// actually we have a nice name for the row, but it wants a char* instead of a const char*. I don't think it is worth copying names ;)
 			char name[r->getName().length()+1];
@@ -197,6 +203,10 @@ const PrecisionPtr& LPPotentials::getPrecision() {
 	return _precision;
 }
 
+void LPPotentials::resetState() {
+	BOOST_SCIP_CALL( SCIPlpiClearState(_lpi) );
+}
+
 
 
 void LPPotentials::setDirections(LPFluxPtr other) {
@@ -216,15 +226,19 @@ void LPPotentials::setDirections(LPFluxPtr other) {
 			//rhs[c.second] = -REACTION_DIRECTIONS_EPSILON;
 			rhs[c.second] = 0;
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, 1) );
+			_side[c.second] = 1;
 		}
 		else if(val < -fluxPrec->getCheckTol()) {
 			//lhs[c.second] = REACTION_DIRECTIONS_EPSILON;
 			lhs[c.second] = 0;
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, -1) );
+			_side[c.second] = -1;
 		}
 		else {
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, 0) );
+			_side[c.second] = 0;
 		}
+		_strict[c.second] = _side[c.second];
 		ind[c.second] = c.second;
 	}
 	BOOST_SCIP_CALL( SCIPlpiChgSides(_lpi, _num_reactions, ind, lhs, rhs));
@@ -247,15 +261,19 @@ void LPPotentials::setDirections(SolutionPtr sol, ScipModelPtr smodel) {
 			//rhs[c.second] = -REACTION_DIRECTIONS_EPSILON;
 			rhs[c.second] = 0;
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, 1) );
+			_side[c.second] = 1;
 		}
 		else if(val < -fluxPrec->getCheckTol()) {
 			//lhs[c.second] = REACTION_DIRECTIONS_EPSILON;
 			lhs[c.second] = 0;
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, -1) );
+			_side[c.second] = -1;
 		}
 		else {
 			BOOST_SCIP_CALL( SCIPlpiChgCoef(_lpi, c.second, 0, 0) );
+			_side[c.second] = 0;
 		}
+		_strict[c.second] = _side[c.second];
 		ind[c.second] = c.second;
 	}
 	BOOST_SCIP_CALL( SCIPlpiChgSides(_lpi, _num_reactions, ind, lhs, rhs));
@@ -274,6 +292,73 @@ void LPPotentials::setDirection(ReactionPtr rxn, bool fwd) {
 	}
 	int ind = _reactions.at(rxn);
 	BOOST_SCIP_CALL( SCIPlpiChgSides(_lpi, 1, &ind, &lhs, &rhs));
+	_side[ind] = fwd ? 1 : -1; // the coefficient of the feastest var is not changed
+}
+
+void LPPotentials::setObj(MetabolitePtr met, double obj) {
+	int ind = _metabolites.at(met);
+	for(unsigned int i = 0; i < _obj_ind.size(); i++) {
+		if(_obj_ind[i] == ind) {
+			_orig_obj[i] = obj;
+			return;
+		}
+	}
+	// zero coefficients are kept in the list, so that optimize also resets them in the LP
+	_obj_ind.push_back(ind);
+	_orig_obj.push_back(obj);
+	_zero_obj.push_back(0);
+}
+
+void LPPotentials::setZeroObj() {
+	std::fill(_orig_obj.begin(), _orig_obj.end(), 0);
+}
+
+void LPPotentials::setFeasibilityCache(ThermoFeasibilityCachePtr cache) {
+	typedef pair<ReactionPtr, int> RxnCon;
+
+	vector<pair<string, int> > names;
+	foreach(RxnCon c, _reactions) {
+		names.push_back(pair<string, int>(c.first->getName(), c.second));
+	}
+	std::sort(names.begin(), names.end());
+
+	_cache.reset();
+	_bit.resize(_num_reactions);
+	for(unsigned int i = 0; i < names.size(); i++) {
+		if(i > 0 && names[i].first == names[i-1].first) {
+			return; // names are ambiguous, so we cannot identify the reactions of other models
+		}
+		_bit[names[i].second] = i;
+	}
+	_cache = cache;
+}
+
+void LPPotentials::getPattern(ThermoFeasibilityCache::Pattern& pattern) {
+	pattern.assign((2*_num_reactions + 63) / 64, 0);
+	for(int i = 0; i < _num_reactions; i++) {
+		if(_side[i] != 0) {
+			unsigned int bit = 2*_bit[i] + (_side[i] > 0 ? 0 : 1);
+			pattern[bit / 64] |= ((uint64_t) 1) << (bit % 64);
+		}
+	}
+}
+
+void LPPotentials::getInfeasibleSubset(ThermoFeasibilityCache::Pattern& pattern) {
+	if(!SCIPlpiIsOptimal(_lpi)) {
+		// we have no certificate, so the only infeasible subset we know is the whole pattern
+		getPattern(pattern);
+		return;
+	}
+	vector<double> dualsol(_num_reactions, 0);
+	BOOST_SCIP_CALL( SCIPlpiGetSol(_lpi, NULL, NULL, dualsol.data(), NULL, NULL) );
+
+	pattern.assign((2*_num_reactions + 63) / 64, 0);
+	for(int i = 0; i < _num_reactions; i++) {
+		if(_side[i] != 0 && dualsol[i] != 0) {
+			unsigned int bit = 2*_bit[i] + (_side[i] > 0 ? 0 : 1);
+			pattern[bit / 64] |= ((uint64_t) 1) << (bit % 64);
+		}
+	}
 }
 
 bool LPPotentials::optimize() {
@@ -301,6 +386,16 @@ bool LPPotentials::optimize() {
 }
 
 bool LPPotentials::testStrictFeasible(bool& result) {
+	// the cache only knows strict tests, so it is skipped if setDirection restricted a row without making it strict
+	ThermoFeasibilityCache::Pattern pattern;
+	bool cached = _cache.use_count() >= 1 && _side == _strict;
+	if(cached) {
+		getPattern(pattern);
+		if(_cache->lookup(pattern, result)) {
+			return true;
+		}
+	}
+
 	// actually solve and test feasibility
 
 	// set feastest objective
@@ -352,6 +447,17 @@ bool LPPotentials::testStrictFeasible(bool& result) {
 	BOOST_SCIP_CALL( SCIPlpiGetObjval(_lpi, &val) );
 
 	result = val >= _precision->getCheckTol(); // test against epsilon (because of rounding issues)
+
+	if(cached) {
+		if(result) {
+			_cache->storeFeasible(pattern);
+		}
+		else {
+			ThermoFeasibilityCache::Pattern subset;
+			getInfeasibleSubset(subset);
+			_cache->storeInfeasible(pattern, subset);
+		}
+	}
 	return true;
 }
 
@@ -29,6 +29,7 @@
 #include "ScipModel.h"
 #include "LPFlux.h"
 #include "model/Precision.h"
+#include "ThermoFeasibilityCache.h"
 #include "Uncopyable.h"
 #include "Properties.h"
 
@@ -109,6 +110,17 @@ public:
 
 	void setDirection(ReactionPtr rxn, bool fwd);
 
+	/**
+	 * Sets the objective coefficient of the potential of met, which is used by #optimize (the LP is maximized).
+	 * Initially, the objective is given by the potential objectives of the model.
+	 */
+	void setObj(MetabolitePtr met, double obj);
+
+	/**
+	 * Sets all objective coefficients to zero.
+	 */
+	void setZeroObj();
+
 	/**
 	 * Computes optimal flux using primal simplex.
 	 *
@@ -121,11 +133,26 @@ public:
 	 */
 	double getPotential(MetabolitePtr met);
 
+	/**
+	 * Shares the results of feasibility tests with other LPPotentials (see ThermoFeasibilityCache).
+	 * Reactions are identified by their names, so that copies of the model can share a cache.
+	 * If the reaction names are not unique, no cache is used.
+	 */
+	void setFeasibilityCache(ThermoFeasibilityCachePtr cache);
+
+	/**
+	 * resets this LPPotentials. The next solve will be from scratch.
+	 */
+	void resetState();
+
 	/**
 	 * checks, if the current problem is strictly feasible
 	 * solves an LP for this
 	 * the result of the feasibility test is stored in result
 	 *
+	 * If a feasibility cache is set and already knows the result for the current directions, no LP is solved.
+	 * In this case, no potentials are computed, so call optimize before fetching potentials.
+	 *
 	 * true is returned, iff we successfully determined the feasibility state
 	 */
 	bool testStrictFeasible(bool& result);
@@ -189,6 +216,22 @@ private:
 	std::vector<double> _zero_obj; // store a zero objective for feas testing
 	std::vector<int> _obj_ind; // store indices of objective coefficients
 
+	ThermoFeasibilityCachePtr _cache; // shared results of feasibility tests, may be empty
+	std::vector<unsigned int> _bit; // position of the reaction of each row in the sign pattern (reactions ordered by name)
+	std::vector<int> _side; // direction restricted by the sides of each row (1 fwd, -1 bwd, 0 none)
+	std::vector<int> _strict; // coefficient of the feastest var in each row, the test is only strict for rows with _strict == _side
+
+	/**
+	 * computes the sign pattern of the current directions for the feasibility cache
+	 */
+	void getPattern(ThermoFeasibilityCache::Pattern& pattern);
+
+	/**
+	 * computes the sign pattern of a subset of the current directions that is already infeasible.
+	 * Rows with a zero dual value in the optimal solution of the feasibility test can be dropped without changing the optimal value.
+	 */
+	void getInfeasibleSubset(ThermoFeasibilityCache::Pattern& pattern);
+
 	SCIP_RETCODE init_lp();
 	SCIP_RETCODE free_lp();
 
@@ -23,6 +23,7 @@
  *      Author: arnem
  */
 
+#include <math.h>
 #include "ScipModel.h"
 #include "objscip/objscip.h"
 #include "objscip/objscipdefplugins.h"
@@ -325,6 +326,38 @@ void ScipModel::solve() {
 	BOOST_SCIP_CALL( SCIPsolve(_scip) );
 }
 
+void ScipModel::freeTransform() {
+	BOOST_SCIP_CALL( SCIPfreeTransform(_scip) );
+}
+
+/**
+ * changes the bounds of an original variable, the order of changes makes sure that lb <= ub holds at any time
+ */
+static void chgVarBounds(SCIP* scip, SCIP_VAR* var, double lb, double ub) {
+	if(lb > SCIPvarGetUbOriginal(var)) {
+		BOOST_SCIP_CALL( SCIPchgVarUb(scip, var, ub) );
+		BOOST_SCIP_CALL( SCIPchgVarLb(scip, var, lb) );
+	}
+	else {
+		BOOST_SCIP_CALL( SCIPchgVarLb(scip, var, lb) );
+		BOOST_SCIP_CALL( SCIPchgVarUb(scip, var, ub) );
+	}
+}
+
+void ScipModel::updateFromModel() {
+	assert(SCIPgetStage(_scip) == SCIP_STAGE_PROBLEM);
+	typedef std::pair<ReactionPtr, SCIP_VAR*> ReactionVar;
+	typedef std::pair<MetabolitePtr, SCIP_VAR*> MetaboliteVar;
+	foreach(ReactionVar r, _reactions) {
+		BOOST_SCIP_CALL( SCIPchgVarObj(_scip, r.second, r.first->getObj()) );
+		chgVarBounds(_scip, r.second, r.first->getLb(), r.first->getUb());
+	}
+	foreach(MetaboliteVar m, _metabolites) {
+		BOOST_SCIP_CALL( SCIPchgVarObj(_scip, m.second, m.first->getPotObj()) );
+		chgVarBounds(_scip, m.second, m.first->getPotLb(), m.first->getPotUb());
+	}
+}
+
 double ScipModel::getObjectiveValue() {
 	assert( SCIPgetStage(_scip) == SCIP_STAGE_SOLVED );  // Problem has not yet been solved!";
 	SCIP_SOL* sol = SCIPgetBestSol(_scip);
@@ -336,6 +369,22 @@ bool ScipModel::isOptimal() {
 	return SCIPgetStatus(_scip) == SCIP_STATUS_OPTIMAL;
 }
 
+double ScipModel::getDualBound() {
+	assert( SCIPgetStage(_scip) >= SCIP_STAGE_TRANSFORMED );  // Problem has not yet been solved!";
+	double bound = SCIPgetDualbound(_scip);
+	if(SCIPisInfinity(_scip, bound)) return INFINITY;
+	if(SCIPisInfinity(_scip, -bound)) return -INFINITY;
+	return bound;
+}
+
+double ScipModel::getPrimalBound() {
+	assert( SCIPgetStage(_scip) >= SCIP_STAGE_TRANSFORMED );  // Problem has not yet been solved!";
+	if(SCIPgetNSols(_scip) == 0) {
+		return isMaximize() ? -INFINITY : INFINITY;
+	}
+	return SCIPgetSolOrigObj(_scip, SCIPgetBestSol(_scip));
+}
+
 bool ScipModel::isUnbounded() {
 	assert( SCIPgetStage(_scip) == SCIP_STAGE_SOLVED );  // Problem has not yet been solved!";
 	return SCIPgetStatus(_scip) == SCIP_STATUS_UNBOUNDED;
@@ -207,6 +207,21 @@ public:
 	 */
 	void solve();
 
+	/**
+	 * Discards all solving data (transformed problem, search tree) and returns to the problem stage,
+	 * so that the problem can be modified and solved again.
+	 * Variables, constraints and plugins, including the helper data they keep, stay alive.
+	 */
+	void freeTransform();
+
+	/**
+	 * Copies objective coefficients and bounds of the reactions and metabolites from the model to the existing variables.
+	 * Use this to solve the same ScipModel again after the model has been changed.
+	 *
+	 * This can only be called during problem stage (see freeTransform).
+	 */
+	void updateFromModel();
+
 	/**
 	 * If the problem has been solved, the best objective value can be fetched using this method.
 	 */
@@ -217,6 +232,20 @@ public:
 	 */
 	bool isOptimal();
 
+	/**
+	 * Returns the best proven bound on the objective value (the dual bound).
+	 * In contrast to getObjectiveValue, this may also be called if solving was interrupted, e.g. by a time limit.
+	 * If no finite bound is known, +/-INFINITY is returned.
+	 */
+	double getDualBound();
+
+	/**
+	 * Returns the objective value of the best solution found so far (the primal bound).
+	 * This may also be called if solving was interrupted, e.g. by a time limit.
+	 * If no solution has been found, -INFINITY is returned for maximization problems and INFINITY for minimization problems.
+	 */
+	double getPrimalBound();
+
 	/**
 	 * If the problem has been solved, checks if the computed solution is unbounded.
 	 */
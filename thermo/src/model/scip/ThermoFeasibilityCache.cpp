@@ -0,0 +1,107 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ThermoFeasibilityCache.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "ThermoFeasibilityCache.h"
+
+using namespace std;
+
+namespace metaopt {
+
+// number of infeasible subsets that are checked on every lookup
+#define MAX_INFEASIBLE_SUBSETS 256
+
+/**
+ * checks if every direction of subset is also restricted in pattern
+ */
+inline bool isSubset(const ThermoFeasibilityCache::Pattern& subset, const ThermoFeasibilityCache::Pattern& pattern) {
+	if(subset.size() != pattern.size()) return false;
+	for(unsigned int i = 0; i < subset.size(); i++) {
+		if((subset[i] & ~pattern[i]) != 0) return false;
+	}
+	return true;
+}
+
+ThermoFeasibilityCache::ThermoFeasibilityCache(unsigned int capacity) : _capacity(capacity), _hits(0), _misses(0) {
+	// nothing to do
+}
+
+ThermoFeasibilityCache::~ThermoFeasibilityCache() {
+	// nothing to do
+}
+
+bool ThermoFeasibilityCache::lookup(const Pattern& pattern, bool& feasible) {
+	std::lock_guard<std::mutex> guard(_lock);
+	boost::unordered_map<Pattern, bool>::iterator iter = _results.find(pattern);
+	if(iter != _results.end()) {
+		feasible = iter->second;
+		_hits++;
+		return true;
+	}
+	foreach(const Pattern& subset, _infeasible) {
+		if(isSubset(subset, pattern)) {
+			feasible = false;
+			_hits++;
+			return true;
+		}
+	}
+	_misses++;
+	return false;
+}
+
+void ThermoFeasibilityCache::storeFeasible(const Pattern& pattern) {
+	std::lock_guard<std::mutex> guard(_lock);
+	if(_results.size() >= _capacity) {
+		_results.clear();
+	}
+	_results[pattern] = true;
+}
+
+void ThermoFeasibilityCache::storeInfeasible(const Pattern& pattern, const Pattern& subset) {
+	std::lock_guard<std::mutex> guard(_lock);
+	if(_results.size() >= _capacity) {
+		_results.clear();
+	}
+	_results[pattern] = false;
+
+	// a subset that is covered by a stored one does not add anything
+	foreach(const Pattern& s, _infeasible) {
+		if(isSubset(s, subset)) return;
+	}
+	_infeasible.push_front(subset);
+	if(_infeasible.size() > MAX_INFEASIBLE_SUBSETS) {
+		_infeasible.pop_back();
+	}
+}
+
+unsigned long ThermoFeasibilityCache::getHits() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _hits;
+}
+
+unsigned long ThermoFeasibilityCache::getMisses() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _misses;
+}
+
+} /* namespace metaopt */
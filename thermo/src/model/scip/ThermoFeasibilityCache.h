@@ -0,0 +1,104 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * ThermoFeasibilityCache.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef THERMOFEASIBILITYCACHE_H_
+#define THERMOFEASIBILITYCACHE_H_
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_map.hpp>
+
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * Caches the results of strict feasibility tests of LPPotentials by the sign pattern of the internal reactions.
+ *
+ * The feasibility of the potential space only depends on the directions of the internal reactions,
+ * so the same test has to be done only once per pattern, even if it is issued by different LPs, CIPs or threads.
+ * A pattern has two bits per reaction: one for the forward and one for the backward direction (see LPPotentials::setFeasibilityCache).
+ *
+ * Additionally, an infeasible subset is stored for every infeasible pattern.
+ * Since restricting more directions never renders an infeasible potential space feasible,
+ * every pattern that contains a stored subset is infeasible, even if the pattern itself was never tested.
+ *
+ * All users of a cache must test the same potential space, i.e. work on (copies of) the same model with the same potential bounds.
+ * If the cache is full, the stored patterns are dropped and the oldest infeasible subset is replaced.
+ * All methods are thread safe.
+ */
+class ThermoFeasibilityCache : Uncopyable {
+public:
+	typedef std::vector<uint64_t> Pattern;
+
+	/**
+	 * Creates a cache holding at most capacity patterns.
+	 */
+	ThermoFeasibilityCache(unsigned int capacity);
+	virtual ~ThermoFeasibilityCache();
+
+	/**
+	 * Looks up the feasibility of the given pattern.
+	 *
+	 * @return true, if the feasibility state is known, it is stored in feasible
+	 */
+	bool lookup(const Pattern& pattern, bool& feasible);
+
+	/**
+	 * Stores that the given pattern is feasible.
+	 */
+	void storeFeasible(const Pattern& pattern);
+
+	/**
+	 * Stores that the given pattern is infeasible, because the given subset of the pattern is already infeasible.
+	 */
+	void storeInfeasible(const Pattern& pattern, const Pattern& subset);
+
+	/**
+	 * Returns the number of lookups that could be answered from the cache.
+	 */
+	unsigned long getHits();
+
+	/**
+	 * Returns the number of lookups that could not be answered from the cache.
+	 */
+	unsigned long getMisses();
+
+private:
+	std::mutex _lock;
+	unsigned int _capacity;
+	boost::unordered_map<Pattern, bool> _results; // feasibility of tested patterns
+	std::deque<Pattern> _infeasible; // infeasible subsets, the newest is at the front
+	unsigned long _hits;
+	unsigned long _misses;
+};
+
+typedef boost::shared_ptr<ThermoFeasibilityCache> ThermoFeasibilityCachePtr;
+
+} /* namespace metaopt */
+#endif /* THERMOFEASIBILITYCACHE_H_ */
@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SharedInfeasibleSetPool.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <algorithm>
+
+#include "SharedInfeasibleSetPool.h"
+#include "model/Reaction.h"
+
+namespace metaopt {
+
+SharedInfeasibleSetPool::SharedInfeasibleSetPool(ModelPtr model, unsigned int capacity) : _capacity(capacity), _version(0) {
+	foreach(ReactionPtr r, model->getInternalReactions()) {
+		_names.push_back(r->getName());
+	}
+	std::sort(_names.begin(), _names.end());
+}
+
+SharedInfeasibleSetPool::~SharedInfeasibleSetPool() {
+	// nothing to do
+}
+
+const std::vector<std::string>& SharedInfeasibleSetPool::getReactionNames() const {
+	return _names;
+}
+
+void SharedInfeasibleSetPool::add(const Set& set) {
+	if(_capacity == 0 || set.empty()) return;
+
+	Set sorted(set);
+	std::sort(sorted.begin(), sorted.end());
+
+	std::lock_guard<std::mutex> guard(_lock);
+	if(_contained.find(sorted) != _contained.end()) return;
+
+	if(_sets.size() < _capacity) {
+		_sets.push_back(sorted);
+	}
+	else {
+		// replace the largest set, if the new one is smaller
+		unsigned int largest = 0;
+		for(unsigned int i = 1; i < _sets.size(); i++) {
+			if(_sets[i].size() > _sets[largest].size()) {
+				largest = i;
+			}
+		}
+		if(_sets[largest].size() <= sorted.size()) return;
+		_contained.erase(_sets[largest]);
+		_sets[largest] = sorted;
+	}
+	_contained.insert(sorted);
+	_version++;
+}
+
+void SharedInfeasibleSetPool::getInfeasibleSets(std::vector<Set>& sets) {
+	std::lock_guard<std::mutex> guard(_lock);
+	sets = _sets;
+}
+
+unsigned long SharedInfeasibleSetPool::getVersion() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _version;
+}
+
+unsigned int SharedInfeasibleSetPool::size() {
+	std::lock_guard<std::mutex> guard(_lock);
+	return _sets.size();
+}
+
+} /* namespace metaopt */
@@ -0,0 +1,103 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * SharedInfeasibleSetPool.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef SHAREDINFEASIBLESETPOOL_H_
+#define SHAREDINFEASIBLESETPOOL_H_
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+#include <boost/unordered_set.hpp>
+
+#include "model/Model.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+/**
+ * A bounded pool of thermodynamically infeasible direction sets that is shared by all CIPs of a run.
+ *
+ * An infeasible set is a set of directed internal reactions, whose potential differences cannot have the corresponding signs simultaneously.
+ * This neither depends on the objective nor on the flux bounds,
+ * so every set found by one CIP can be used by all other CIPs on (copies of) the same model with the same potential bounds.
+ *
+ * Since the CIPs usually operate on different copies of the model, reactions are identified by their index in getReactionNames().
+ * A directed reaction is encoded as 2*index for the forward and 2*index+1 for the backward direction,
+ * and a set is stored as sorted vector of these codes.
+ *
+ * Small sets are more useful than large ones, so if the pool is full, the largest set is replaced.
+ * All methods are thread safe.
+ */
+class SharedInfeasibleSetPool : Uncopyable {
+public:
+	typedef std::vector<unsigned int> Set;
+
+	/**
+	 * Creates a pool for infeasible sets of the internal reactions of the given model, holding at most capacity sets.
+	 */
+	SharedInfeasibleSetPool(ModelPtr model, unsigned int capacity);
+	virtual ~SharedInfeasibleSetPool();
+
+	/**
+	 * Returns the names of the internal reactions in the order used for encoding the sets (sorted by name).
+	 */
+	const std::vector<std::string>& getReactionNames() const;
+
+	/**
+	 * Adds an infeasible set. The set does not need to be sorted.
+	 * If the pool already contains the same set, nothing happens.
+	 */
+	void add(const Set& set);
+
+	/**
+	 * Fetches all stored infeasible sets.
+	 */
+	void getInfeasibleSets(std::vector<Set>& sets);
+
+	/**
+	 * Returns a number that changes whenever the content of the pool changes,
+	 * so that users can avoid fetching the same sets again.
+	 */
+	unsigned long getVersion();
+
+	/**
+	 * Returns the number of sets in the pool.
+	 */
+	unsigned int size();
+
+private:
+	std::mutex _lock;
+	std::vector<std::string> _names;
+	unsigned int _capacity;
+	std::vector<Set> _sets;
+	boost::unordered_set<Set> _contained; // for detecting duplicates
+	unsigned long _version;
+};
+
+typedef boost::shared_ptr<SharedInfeasibleSetPool> SharedInfeasibleSetPoolPtr;
+
+} /* namespace metaopt */
+#endif /* SHAREDINFEASIBLESETPOOL_H_ */
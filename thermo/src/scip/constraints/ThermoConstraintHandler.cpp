@@ -125,6 +125,8 @@ ThermoConstraintHandler::ThermoConstraintHandler(ScipModelPtr model) :
 
 	_pot_test = LPPotentialsPtr( new LPPotentials(_model)); // this cannot be initialized after presolving, because check may already be run earlier
 	_pot_test->setPrecision(model->getPotPrecision()); // solve this with potential precision, it is only used once in the check routine
+
+	_shared_version = 0;
 }
 
 ThermoConstraintHandler::~ThermoConstraintHandler() {
@@ -135,6 +137,130 @@ void ThermoConstraintHandler::setCouplingHint(CouplingPtr coupling) {
 	_coupling = coupling;
 }
 
+void ThermoConstraintHandler::setFeasibilityCache(ThermoFeasibilityCachePtr cache) {
+	_feas_cache = cache;
+	if(_feas_cache.use_count() >= 1) {
+		_pot_test->setFeasibilityCache(_feas_cache);
+	}
+}
+
+void ThermoConstraintHandler::setInfeasibleSetPool(SharedInfeasibleSetPoolPtr pool) {
+	_shared_pool = pool;
+	_shared_rxns.clear();
+	_shared_index.clear();
+	_shared_sets.clear();
+	_shared_version = 0; // version 0 is the empty pool
+	if(_shared_pool.use_count() == 0) return;
+
+	unordered_map<string, ReactionPtr> byName;
+	foreach(ReactionPtr rxn, _model->getInternalReactions()) {
+		byName[rxn->getName()] = rxn;
+	}
+	const vector<string>& names = _shared_pool->getReactionNames();
+	for(unsigned int i = 0; i < names.size(); i++) {
+		unordered_map<string, ReactionPtr>::iterator iter = byName.find(names[i]);
+		if(iter != byName.end()) {
+			_shared_index[iter->second] = i;
+			_shared_rxns.push_back(iter->second);
+		}
+		else {
+			_shared_rxns.push_back(ReactionPtr());
+		}
+	}
+}
+
+void ThermoConstraintHandler::shareInfeasibleSet(ThermoInfeasibleSetPtr tis, ISSupplyPtr iss) {
+	unordered_set<DirectedReaction> set(tis->set);
+	vector<PotSpaceConstraintPtr> apscs = iss->getActivePotConstraints();
+	foreach(PotSpaceConstraintPtr apsc, apscs) {
+		DirectedReaction d = apsc->_cover->reaction;
+		d._fwd = !d._fwd;
+		set.insert(d);
+		foreach(DirectedReaction& c, *(apsc->_cover->covered)) {
+			DirectedReaction ccopy = c;
+			ccopy._fwd = !c._fwd;
+			set.insert(ccopy);
+		}
+	}
+
+	SharedInfeasibleSetPool::Set codes;
+	foreach(const DirectedReaction& d, set) {
+		unordered_map<ReactionPtr, unsigned int>::iterator iter = _shared_index.find(d._rxn);
+		if(iter == _shared_index.end()) return; // the other CIPs do not know this reaction
+		codes.push_back(2*iter->second + (d._fwd ? 0 : 1));
+	}
+	_shared_pool->add(codes);
+}
+
+SCIP_RESULT ThermoConstraintHandler::enforceSharedSets(SolutionPtr& sol) {
+	ScipModelPtr model = getScip();
+	const PrecisionPtr& modelPrec = model->getPrecision();
+
+	// only translate the sets again, if the pool changed
+	unsigned long version = _shared_pool->getVersion();
+	if(version != _shared_version) {
+		vector<SharedInfeasibleSetPool::Set> sets;
+		_shared_pool->getInfeasibleSets(sets);
+		_shared_version = version;
+		_shared_sets.clear();
+		foreach(const SharedInfeasibleSetPool::Set& s, sets) {
+			vector<DirectedReaction> set;
+			foreach(unsigned int code, s) {
+				ReactionPtr rxn = _shared_rxns.at(code / 2);
+				if(rxn.use_count() == 0) break;
+				set.push_back(DirectedReaction(rxn, code % 2 == 0));
+			}
+			if(set.size() == s.size()) {
+				_shared_sets.push_back(set);
+			}
+		}
+	}
+
+	boost::shared_ptr<unordered_set<ReactionPtr> > fixedDirs = model->getFixedDirections();
+	foreach(vector<DirectedReaction>& set, _shared_sets) {
+		bool applies = true;
+		foreach(DirectedReaction& d, set) {
+			double val = model->getFlux(sol, d._rxn);
+			if(d._fwd ? val <= modelPrec->getCheckTol() : val >= -modelPrec->getCheckTol()) {
+				applies = false;
+				break;
+			}
+		}
+		if(!applies) continue;
+
+		// every thermodynamically feasible flux blocks at least one of the directions
+		vector<DirectedReaction> candidates;
+		foreach(DirectedReaction& d, set) {
+			if(fixedDirs->find(d._rxn) == fixedDirs->end()) { // not fixed
+				candidates.push_back(d);
+			}
+		}
+
+#ifdef LOGBRANCHING
+		cout << "Applying shared infeasible set of size " << set.size() << endl;
+#endif
+		if(candidates.empty()) {
+			return SCIP_CUTOFF;
+		}
+		else if(candidates.size() == 1) {
+			SCIP_NODE* node = SCIPgetCurrentNode(model->getScip());
+			model->setBlockedFlux(node, candidates[0]._rxn, candidates[0]._fwd);
+			return SCIP_REDUCEDDOM;
+		}
+		else {
+			foreach(DirectedReaction& d, candidates) {
+				SCIP_NODE* node;
+				double prio = model->getFlux(sol, d._rxn);
+				double estimate = SCIPgetLocalTransEstimate(model->getScip());
+				BOOST_SCIP_CALL( SCIPcreateChild(model->getScip(), &node, prio, estimate) );
+				model->setBlockedFlux(node, d._rxn, d._fwd);
+			}
+			return SCIP_BRANCHED;
+		}
+	}
+	return SCIP_FEASIBLE;
+}
+
 SCIP_RESULT ThermoConstraintHandler::enforceObjectiveCycles(SolutionPtr& sol) {
 	ScipModelPtr model = getScip();
 	const PrecisionPtr& modelPrec = model->getPrecision();
@@ -329,6 +455,10 @@ SCIP_RESULT ThermoConstraintHandler::branchCycle(SolutionPtr& sol) {
 	_infeas_pool.add(tis);
 #endif
 
+	if(_shared_pool.use_count() >= 1) {
+		shareInfeasibleSet(tis, _cycle_find);
+	}
+
 	return branch(branchingCandidates, _cycle_find, sol);
 }
 
@@ -452,6 +582,25 @@ SCIP_RESULT ThermoConstraintHandler::branchIS(SolutionPtr& sol) {
 		bool good = false;
 #endif
 
+#if !THERMOCONS_USE_AGGR_RXN
+		if(_shared_pool.use_count() >= 1) {
+			// the directions of the infeasible set are the directions of _flux_simpl
+			ThermoInfeasibleSetPtr tis(new ThermoInfeasibleSet());
+			foreach(ReactionPtr rxn, *is) {
+				double val = _flux_simpl->getFlux(rxn);
+				if(val > modelPrec->getCheckTol()) {
+					tis->set.insert(DirectedReaction(rxn, true));
+				}
+				else if(val < -modelPrec->getCheckTol()) {
+					tis->set.insert(DirectedReaction(rxn, false));
+				}
+			}
+			if(tis->set.size() == is->size()) { // don't share sets with undetermined directions
+				shareInfeasibleSet(tis, _is_find);
+			}
+		}
+#endif
+
 		unordered_set<DirectedReaction> branchingCandidates;
 
 		foreach(ReactionPtr rxn, *is) {
@@ -792,6 +941,12 @@ SCIP_RETCODE ThermoConstraintHandler::enforce(SCIP_CONS** conss, int nconss, SCI
 		_is_find->setExtraPotConstraints(extra); // used to find general infeasible sets
 		// the other LPFluxS are not used as ISSuply
 
+		// 0th step: exclude infeasible sets that other CIPs already found
+		if(_shared_pool.use_count() >= 1) {
+			*result = enforceSharedSets(solptr);
+			assert(solptr.unique());
+			if(*result != SCIP_FEASIBLE) return SCIP_OKAY;
+		}
 
 		// 1st step: try finding objective cycles
 		*result = enforceObjectiveCycles(solptr);
@@ -1149,6 +1304,9 @@ SCIP_RETCODE ThermoConstraintHandler::scip_exitpre(
 	_flux_simpl = LPFluxPtr( new LPFlux(_reduced, true));
 	_is_find = DualPotentialsPtr( new DualPotentials(_model)); //I cannot use the reduced model here, because I would lose infeasible sets
 	_pot_test = LPPotentialsPtr( new LPPotentials(_model)); // it doesn't make sense to use the reduced model, since this is only used for testing
+	if(_feas_cache.use_count() >= 1) {
+		_pot_test->setFeasibilityCache(_feas_cache);
+	}
 #else
 
 	// even if we do not use the results of the presolver to directly simplify the model, we can use that to infer coupling relations
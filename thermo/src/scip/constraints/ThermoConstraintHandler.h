@@ -38,6 +38,7 @@
 #include "model/scip/ISSupply.h"
 #include "model/scip/PotSpaceConstraint.h"
 #include "scip/constraints/ThermoInfeasibleSetPool.h"
+#include "scip/constraints/SharedInfeasibleSetPool.h"
 #include "Properties.h"
 
 // set to 1 to use aggregated reactions instead of the original reactions (not correctly implemented yet)
@@ -68,6 +69,17 @@ public:
 	 */
 	void setCouplingHint(CouplingPtr coupling);
 
+	/**
+	 * Shares the results of the feasibility checks with other CIPs and heuristics (see ThermoFeasibilityCache).
+	 */
+	void setFeasibilityCache(ThermoFeasibilityCachePtr cache);
+
+	/**
+	 * Shares the infeasible sets found by this handler with other CIPs and uses the sets found by them (see SharedInfeasibleSetPool).
+	 * Reactions are identified by their names, so that CIPs on copies of the model can share a pool.
+	 */
+	void setInfeasibleSetPool(SharedInfeasibleSetPoolPtr pool);
+
 	/**
 	 * branch on the cycle of the current solution of _cycle_find
 	 */
@@ -78,6 +90,12 @@ public:
 	 */
 	SCIP_RESULT enforceObjectiveCycles(SolutionPtr& sol);
 
+	/**
+	 * checks if the current solution uses all directions of an infeasible set of the shared pool, and if so, branches on it.
+	 * The directions of such a set cannot be used simultaneously, so every child blocks one of them.
+	 */
+	SCIP_RESULT enforceSharedSets(SolutionPtr& sol);
+
 	/**
 	 * find an infeasible set in _flux_simpl and branch on it
 	 */
@@ -226,10 +244,18 @@ private:
 
 	// for checking feasibility
 	LPPotentialsPtr _pot_test;
+	ThermoFeasibilityCachePtr _feas_cache; // shared results of feasibility checks, may be empty
 
 	// this pool is used to store already found infeasible sets, so that we don't have to go looking again.
 	ThermoInfeasibleSetPool _infeas_pool;
 
+	// infeasible sets shared with the other CIPs of a run, may be empty
+	SharedInfeasibleSetPoolPtr _shared_pool;
+	std::vector<ReactionPtr> _shared_rxns; // reactions of _model in the order of the pool (empty pointer if _model has no such reaction)
+	boost::unordered_map<ReactionPtr, unsigned int> _shared_index; // index of the reactions of _model in the pool
+	std::vector<std::vector<DirectedReaction> > _shared_sets; // sets of the pool translated to _model
+	unsigned long _shared_version; // version of the pool when _shared_sets was fetched
+
 
 	// propagates potential bounds that can be used to detect disabled reactions
 #if 0
@@ -289,6 +315,13 @@ private:
 	 */
 	void addPotSpaceConstraint(PotSpaceConstraintPtr psc, SCIP_NODE* node);
 
+	/**
+	 * Adds an infeasible set to the shared pool.
+	 * The set is only infeasible together with the active pot space constraints of iss,
+	 * so the reversed directions these constraints originate from are added as well.
+	 */
+	void shareInfeasibleSet(ThermoInfeasibleSetPtr tis, ISSupplyPtr iss);
+
 };
 
 inline ScipModelPtr ThermoConstraintHandler::getScip() {
@@ -327,6 +360,27 @@ inline void createThermoConstraint(ScipModelPtr model, CouplingPtr c) {
 	BOOST_SCIP_CALL( SCIPreleaseCons(scip, &cons) );
 }
 
+/**
+ * Creates Thermo constraint with hint on flux coupled reactions (may be empty)
+ * that shares feasibility checks using the given cache and infeasible sets using the given pool (both may be empty)
+ */
+inline void createThermoConstraint(ScipModelPtr model, CouplingPtr c, ThermoFeasibilityCachePtr cache, SharedInfeasibleSetPoolPtr pool = SharedInfeasibleSetPoolPtr()) {
+	ThermoConstraintHandler* handler = new ThermoConstraintHandler(model);
+	if(c.use_count() >= 1) {
+		handler->setCouplingHint(c);
+	}
+	handler->setFeasibilityCache(cache);
+	handler->setInfeasibleSetPool(pool);
+	SCIP* scip = model->getScip();
+	BOOST_SCIP_CALL( SCIPincludeObjConshdlr( scip, handler, TRUE ) );
+	// we now have to add the default constraint
+	SCIP_CONSHDLR* hdlr = SCIPfindConshdlr( scip, THERMO_CONSTRAINT_NAME);
+	SCIP_CONS* cons;
+	BOOST_SCIP_CALL( SCIPcreateCons(scip, &cons, "default thermo constraint", hdlr, NULL, true, true, true, true, true, false, false, false, false, false) );
+	BOOST_SCIP_CALL( SCIPaddCons(scip, cons) );
+	BOOST_SCIP_CALL( SCIPreleaseCons(scip, &cons) );
+}
+
 
 } /* namespace metaopt */
 #endif /* THERMOCONSTRAINTHANDLER_H_ */
@@ -0,0 +1,90 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * BoundReachedEventHandler.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include <math.h>
+#include "scip/scip.h"
+
+#include "BoundReachedEventHandler.h"
+#include "scip/ScipError.h"
+#include "Properties.h"
+
+using namespace scip;
+using namespace boost;
+
+namespace metaopt {
+
+BoundReachedEventHandler::BoundReachedEventHandler(ScipModelPtr scip) :
+		ObjEventhdlr(scip->getScip(), BOUND_REACHED_EVENTHDLR_NAME,
+				"interrupts solving if an incumbent attains a known bound on the objective value") {
+	_scip = scip;
+	_bound = INFINITY;
+	_filterpos = -1;
+}
+
+BoundReachedEventHandler::~BoundReachedEventHandler() {
+	// nothing to do
+}
+
+void BoundReachedEventHandler::setBound(double bound) {
+	_bound = bound;
+}
+
+bool BoundReachedEventHandler::isReached(double obj) {
+	ScipModelPtr scip = getScip();
+	double tol = scip->getPrecision()->getCheckTol();
+	if(scip->isMaximize()) {
+		return obj >= _bound - tol;
+	}
+	else {
+		return obj <= _bound + tol;
+	}
+}
+
+SCIP_RETCODE BoundReachedEventHandler::scip_initsol(SCIP* scip, SCIP_EVENTHDLR* eventhdlr) {
+	SCIP_CALL( SCIPcatchEvent(scip, SCIP_EVENTTYPE_BESTSOLFOUND, eventhdlr, NULL, &_filterpos) );
+	return SCIP_OKAY;
+}
+
+SCIP_RETCODE BoundReachedEventHandler::scip_exitsol(SCIP* scip, SCIP_EVENTHDLR* eventhdlr) {
+	SCIP_CALL( SCIPdropEvent(scip, SCIP_EVENTTYPE_BESTSOLFOUND, eventhdlr, NULL, _filterpos) );
+	_filterpos = -1;
+	return SCIP_OKAY;
+}
+
+SCIP_RETCODE BoundReachedEventHandler::scip_exec(SCIP* scip, SCIP_EVENTHDLR* eventhdlr, SCIP_EVENT* event, SCIP_EVENTDATA* eventdata) {
+	SCIP_SOL* sol = SCIPeventGetSol(event);
+	if(isReached(SCIPgetSolOrigObj(scip, sol))) {
+		SCIP_CALL( SCIPinterruptSolve(scip) );
+	}
+	return SCIP_OKAY;
+}
+
+BoundReachedEventHandler* createBoundReachedEventHandler(ScipModelPtr scip) {
+	// scip takes care of freeing the handler
+	BoundReachedEventHandler* handler = new BoundReachedEventHandler(scip);
+	BOOST_SCIP_CALL( SCIPincludeObjEventhdlr(scip->getScip(), handler, true) );
+	return handler;
+}
+
+} /* namespace metaopt */
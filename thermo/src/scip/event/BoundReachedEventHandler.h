@@ -0,0 +1,105 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * BoundReachedEventHandler.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef BOUNDREACHEDEVENTHANDLER_H_
+#define BOUNDREACHEDEVENTHANDLER_H_
+
+#include "objscip/objscip.h"
+#include "model/scip/ScipModel.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+#define BOUND_REACHED_EVENTHDLR_NAME "BoundReachedEventHandler"
+
+/**
+ * Interrupts the solving process as soon as a solution is found whose objective value reaches a known bound.
+ *
+ * If we already know a bound on the optimal objective value (for example the optimum of an LP relaxation),
+ * a solution that attains this bound (up to the check tolerance of the model) is optimal and there is no need to prove optimality by branching.
+ * After the interrupt, SCIP reports the status SCIP_STATUS_USERINTERRUPT.
+ */
+class BoundReachedEventHandler : public scip::ObjEventhdlr, Uncopyable {
+public:
+	BoundReachedEventHandler(ScipModelPtr scip);
+	virtual ~BoundReachedEventHandler();
+
+	/**
+	 * Sets the known bound on the objective value (in the original objective sense).
+	 * Use INFINITY (for maximization) or -INFINITY (for minimization) if no bound is known.
+	 */
+	void setBound(double bound);
+
+	/**
+	 * Checks if the objective value of a solution reaches the bound.
+	 */
+	bool isReached(double obj);
+
+	/**
+	 * interface method to scip, starts catching new incumbents
+	 */
+	virtual SCIP_RETCODE scip_initsol(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr
+		);
+
+	/**
+	 * interface method to scip, stops catching new incumbents
+	 */
+	virtual SCIP_RETCODE scip_exitsol(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr
+		);
+
+	/**
+	 * interface method to scip, called if a new incumbent was found
+	 */
+	virtual SCIP_RETCODE scip_exec(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr,
+		SCIP_EVENT*        	event,
+		SCIP_EVENTDATA*    	eventdata
+		);
+
+private:
+	boost::weak_ptr<ScipModel> _scip;
+	double _bound;
+	int _filterpos; // position of the event in the event filter, needed for dropping it
+
+	inline ScipModelPtr getScip() const;
+};
+
+ScipModelPtr BoundReachedEventHandler::getScip() const {
+	return _scip.lock();
+}
+
+/**
+ * creates and registers a new BoundReachedEventHandler.
+ * The handler is owned by scip, the returned pointer is valid as long as scip lives.
+ */
+BoundReachedEventHandler* createBoundReachedEventHandler(ScipModelPtr scip);
+
+} /* namespace metaopt */
+#endif /* BOUNDREACHEDEVENTHANDLER_H_ */
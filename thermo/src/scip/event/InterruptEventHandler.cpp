@@ -0,0 +1,82 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * InterruptEventHandler.cpp
+ *
+ *  Created on: 17.10.2026
+ */
+
+#include "scip/scip.h"
+
+#include "InterruptEventHandler.h"
+#include "scip/ScipError.h"
+#include "Properties.h"
+
+using namespace scip;
+using namespace boost;
+
+namespace metaopt {
+
+#define INTERRUPT_EVENTTYPES (SCIP_EVENTTYPE_LPSOLVED | SCIP_EVENTTYPE_NODESOLVED)
+
+InterruptEventHandler::InterruptEventHandler(ScipModelPtr scip, CancellationTokenPtr token) :
+		ObjEventhdlr(scip->getScip(), INTERRUPT_EVENTHDLR_NAME,
+				"interrupts solving if a token is cancelled by another thread") {
+	_token = token;
+	_filterpos = -1;
+}
+
+InterruptEventHandler::~InterruptEventHandler() {
+	// nothing to do
+}
+
+void InterruptEventHandler::setFlag(CancellationTokenPtr flag) {
+	_flag = flag;
+}
+
+bool InterruptEventHandler::isRaised() const {
+	return (_token && _token->isCancelled()) || (_flag && _flag->isCancelled());
+}
+
+SCIP_RETCODE InterruptEventHandler::scip_initsol(SCIP* scip, SCIP_EVENTHDLR* eventhdlr) {
+	SCIP_CALL( SCIPcatchEvent(scip, INTERRUPT_EVENTTYPES, eventhdlr, NULL, &_filterpos) );
+	return SCIP_OKAY;
+}
+
+SCIP_RETCODE InterruptEventHandler::scip_exitsol(SCIP* scip, SCIP_EVENTHDLR* eventhdlr) {
+	SCIP_CALL( SCIPdropEvent(scip, INTERRUPT_EVENTTYPES, eventhdlr, NULL, _filterpos) );
+	_filterpos = -1;
+	return SCIP_OKAY;
+}
+
+SCIP_RETCODE InterruptEventHandler::scip_exec(SCIP* scip, SCIP_EVENTHDLR* eventhdlr, SCIP_EVENT* event, SCIP_EVENTDATA* eventdata) {
+	if(isRaised()) {
+		SCIP_CALL( SCIPinterruptSolve(scip) );
+	}
+	return SCIP_OKAY;
+}
+
+InterruptEventHandler* createInterruptEventHandler(ScipModelPtr scip, CancellationTokenPtr token) {
+	// scip takes care of freeing the handler
+	InterruptEventHandler* handler = new InterruptEventHandler(scip, token);
+	BOOST_SCIP_CALL( SCIPincludeObjEventhdlr(scip->getScip(), handler, true) );
+	return handler;
+}
+
+} /* namespace metaopt */
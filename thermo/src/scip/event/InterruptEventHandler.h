@@ -0,0 +1,102 @@
+/* * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * *
+    fast-tfva - efficient thermodynamic constrained flux variability analysis.
+    Copyright (C) 2012  Arne Müller, arne.mueller@fu-berlin.de
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+/*
+ * InterruptEventHandler.h
+ *
+ *  Created on: 17.10.2026
+ */
+
+#ifndef INTERRUPTEVENTHANDLER_H_
+#define INTERRUPTEVENTHANDLER_H_
+
+#include "objscip/objscip.h"
+#include "model/scip/ScipModel.h"
+#include "CancellationToken.h"
+#include "Uncopyable.h"
+#include "Properties.h"
+
+namespace metaopt {
+
+#define INTERRUPT_EVENTHDLR_NAME "InterruptEventHandler"
+
+/**
+ * Interrupts the solving process as soon as a CancellationToken is cancelled, possibly by another thread.
+ *
+ * The handler polls two tokens: the token given on creation, which usually cancels the whole computation,
+ * and a flag that can be exchanged between solves (e.g. to stop a CIP that lost a race).
+ *
+ * SCIPinterruptSolve must not be called from a different thread than the one running SCIP,
+ * so the tokens are only polled whenever SCIP finished an LP or a node.
+ * After the interrupt, SCIP reports the status SCIP_STATUS_USERINTERRUPT.
+ */
+class InterruptEventHandler : public scip::ObjEventhdlr, Uncopyable {
+public:
+	InterruptEventHandler(ScipModelPtr scip, CancellationTokenPtr token);
+	virtual ~InterruptEventHandler();
+
+	/**
+	 * Sets the flag that is polled in addition to the token. Pass an empty pointer to remove the flag.
+	 */
+	void setFlag(CancellationTokenPtr flag);
+
+	/**
+	 * Checks if the token or the flag is cancelled.
+	 */
+	bool isRaised() const;
+
+	/**
+	 * interface method to scip, starts catching solved LPs and nodes
+	 */
+	virtual SCIP_RETCODE scip_initsol(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr
+		);
+
+	/**
+	 * interface method to scip, stops catching solved LPs and nodes
+	 */
+	virtual SCIP_RETCODE scip_exitsol(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr
+		);
+
+	/**
+	 * interface method to scip, called if an LP or a node was solved
+	 */
+	virtual SCIP_RETCODE scip_exec(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_EVENTHDLR*    	eventhdlr,
+		SCIP_EVENT*        	event,
+		SCIP_EVENTDATA*    	eventdata
+		);
+
+private:
+	CancellationTokenPtr _token;
+	CancellationTokenPtr _flag;
+	int _filterpos; // position of the event in the event filter, needed for dropping it
+};
+
+/**
+ * creates and registers a new InterruptEventHandler polling the given token (which may be empty).
+ * The handler is owned by scip, the returned pointer is valid as long as scip lives.
+ */
+InterruptEventHandler* createInterruptEventHandler(ScipModelPtr scip, CancellationTokenPtr token = CancellationTokenPtr());
+
+} /* namespace metaopt */
+#endif /* INTERRUPTEVENTHANDLER_H_ */
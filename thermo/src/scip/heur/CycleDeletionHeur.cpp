@@ -60,6 +60,10 @@ CycleDeletionHeur::~CycleDeletionHeur() {
 	// nothing to do
 }
 
+void CycleDeletionHeur::setFeasibilityCache(ThermoFeasibilityCachePtr cache) {
+	_potentials->setFeasibilityCache(cache);
+}
+
 SCIP_RETCODE CycleDeletionHeur::scip_exec(SCIP* scip, SCIP_HEUR* heur, SCIP_HEURTIMING timing, SCIP_Bool nodeinfeasible, SCIP_RESULT* result) {
 	if(!isDifficult()) {
 		//std::cout << "running heur" << std::endl;
@@ -122,6 +126,16 @@ SCIP_RETCODE CycleDeletionHeur::scip_exec(SCIP* scip, SCIP_HEUR* heur, SCIP_HEUR
 	}
 }
 
+SCIP_RETCODE CycleDeletionHeur::scip_initsol(SCIP* scip, SCIP_HEUR* heur) {
+	ScipModelPtr smodel = getScip();
+	_difficultyTestFlux->setObjSense(smodel->isMaximize());
+	foreach(ReactionPtr rxn, smodel->getModel()->getInternalReactions()) {
+		_difficultyTestFlux->setObj(rxn, rxn->getObj());
+	}
+	_tflux->setBounds(smodel); // in this stage, the current bounds are the bounds of the original problem
+	return SCIP_OKAY;
+}
+
 bool CycleDeletionHeur::isDifficult() {
 	ScipModelPtr scip = getScip();
 	// first check if the LP was really solved to optimality
@@ -285,4 +299,12 @@ void createCycleDeletionHeur(ScipModelPtr scip) {
 	BOOST_SCIP_CALL( SCIPincludeObjHeur(scip->getScip(), heur, true) );
 }
 
+void createCycleDeletionHeur(ScipModelPtr scip, ThermoFeasibilityCachePtr cache) {
+	CycleDeletionHeur* heur = new CycleDeletionHeur(scip);
+	if(cache.use_count() >= 1) {
+		heur->setFeasibilityCache(cache);
+	}
+	BOOST_SCIP_CALL( SCIPincludeObjHeur(scip->getScip(), heur, true) );
+}
+
 } /* namespace metaopt */
@@ -51,6 +51,20 @@ public:
 		SCIP_RESULT *    	result
 		);
 
+	/**
+	 * interface method to scip, called before the branch and bound process starts.
+	 * If the ScipModel is solved repeatedly, objective and bounds may have changed since the last solve, so the helper LPs are updated.
+	 */
+	virtual SCIP_RETCODE scip_initsol(
+		SCIP*              	scip,               /**< SCIP data structure */
+		SCIP_HEUR*   	 	heur
+		);
+
+	/**
+	 * Shares the results of the feasibility tests of the computed potentials with other CIPs and heuristics (see ThermoFeasibilityCache).
+	 */
+	void setFeasibilityCache(ThermoFeasibilityCachePtr cache);
+
 private:
 	boost::weak_ptr<ScipModel> _scip;
 	LPFluxPtr _difficultyTestFlux; // flux for checking if objective reactions are contained in internal circuits, contains only internal reactions
@@ -93,6 +107,11 @@ ScipModelPtr CycleDeletionHeur::getScip() const {
  */
 void createCycleDeletionHeur(ScipModelPtr scip);
 
+/**
+ * creates and registers a new CycleDeletionHeur that shares feasibility tests using the given cache
+ */
+void createCycleDeletionHeur(ScipModelPtr scip, ThermoFeasibilityCachePtr cache);
+
 typedef boost::shared_ptr<CycleDeletionHeur> CycleDeletionHeurPtr;
 
 } /* namespace metaopt */